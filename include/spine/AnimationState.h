@@ -148,6 +148,22 @@ SP_API spTrackEntry* spAnimationState_getCurrent (spAnimationState* self, int tr
 
 SP_API void spAnimationState_clearListenerNotifications(spAnimationState* self);
 
+/* Restricts the timelines a track applies to the bones and slots whose flag is non-zero. Each mask has one flag per bone or
+ * slot of the skeleton data and is copied. Masked timelines are skipped when the track's timelines are set up, so they cost
+ * nothing when applying. Draw order, event and constraint timelines are never masked.
+ * @param boneMask May be 0 to apply all bone timelines.
+ * @param slotMask May be 0 to apply all slot timelines. If both are 0 the track's mask is removed. */
+SP_API void spAnimationState_setTrackMask (spAnimationState* self, int trackIndex, const unsigned char* boneMask, const unsigned char* slotMask);
+
+/* Copies the tracks, including queued and mixing entries and their rotation mix state, into buffer. Returns the snapshot
+ * size in bytes, if it is larger than capacity the snapshot is incomplete and must be taken again with a larger buffer.
+ * Animations, listeners and user data are referenced by address, so the snapshot is only valid for this state. */
+SP_API int spAnimationState_saveState (spAnimationState* self, void* buffer, int capacity);
+/* Replaces the tracks with a snapshot taken by spAnimationState_saveState. The current entries are released without
+ * notifying listeners and pending notifications are discarded. Returns the number of bytes read, or 0 if the buffer does not
+ * hold a valid snapshot, in which case the state is unchanged. */
+SP_API int spAnimationState_loadState (spAnimationState* self, const void* buffer, int size);
+
 SP_API float spTrackEntry_getAnimationTime (spTrackEntry* entry);
 
 /** Use this to dispose static memory before your app exits to appease your memory leak detector*/
@@ -178,6 +194,9 @@ typedef spAnimationState AnimationState;
 #define AnimationState_addEmptyAnimation(...) spAnimatinState_addEmptyAnimation(__VA_ARGS__)
 #define AnimationState_setEmptyAnimations(...) spAnimatinState_setEmptyAnimations(__VA_ARGS__)
 #define AnimationState_getCurrent(...) spAnimationState_getCurrent(__VA_ARGS__)
+#define AnimationState_setTrackMask(...) spAnimationState_setTrackMask(__VA_ARGS__)
+#define AnimationState_saveState(...) spAnimationState_saveState(__VA_ARGS__)
+#define AnimationState_loadState(...) spAnimationState_loadState(__VA_ARGS__)
 #define AnimationState_clearListenerNotifications(...) spAnimatinState_clearListenerNotifications(__VA_ARGS__)
 #endif
 
@@ -54,6 +54,9 @@ typedef struct spAnimationStateData {
 } spAnimationStateData;
 
 SP_API spAnimationStateData* spAnimationStateData_create (spSkeletonData* skeletonData);
+/* Creates state data whose mixes override those of the parent, which must outlive it. Mixes not set on the overlay are
+ * looked up in the parent before falling back to the overlay's defaultMix, which starts as the parent's. */
+SP_API spAnimationStateData* spAnimationStateData_createOverlay (spAnimationStateData* parent);
 SP_API void spAnimationStateData_dispose (spAnimationStateData* self);
 
 SP_API void spAnimationStateData_setMixByName (spAnimationStateData* self, const char* fromName, const char* toName, float duration);
@@ -64,6 +67,7 @@ SP_API float spAnimationStateData_getMix (spAnimationStateData* self, spAnimatio
 #ifdef SPINE_SHORT_NAMES
 typedef spAnimationStateData AnimationStateData;
 #define AnimationStateData_create(...) spAnimationStateData_create(__VA_ARGS__)
+#define AnimationStateData_createOverlay(...) spAnimationStateData_createOverlay(__VA_ARGS__)
 #define AnimationStateData_dispose(...) spAnimationStateData_dispose(__VA_ARGS__)
 #define AnimationStateData_setMixByName(...) spAnimationStateData_setMixByName(__VA_ARGS__)
 #define AnimationStateData_setMix(...) spAnimationStateData_setMix(__VA_ARGS__)
@@ -41,6 +41,9 @@ extern "C" {
 
 struct spSkeleton;
 
+/* Number of floats kept for the inputs and results of the last solve. */
+#define SP_IKCONSTRAINT_CACHE_SIZE 36
+
 typedef struct spIkConstraint {
 	spIkConstraintData* const data;
 
@@ -51,6 +54,11 @@ typedef struct spIkConstraint {
 	int bendDirection;
 	float mix;
 
+	/* The bones are only solved again when an input differs from the last spIkConstraint_apply. */
+	int/*bool*/ cacheValid;
+	float cacheInputs[SP_IKCONSTRAINT_CACHE_SIZE];
+	float cacheOutputs[SP_IKCONSTRAINT_CACHE_SIZE];
+
 #ifdef __cplusplus
 	spIkConstraint() :
 		data(0),
@@ -58,7 +66,8 @@ typedef struct spIkConstraint {
 		bones(0),
 		target(0),
 		bendDirection(0),
-		mix(0) {
+		mix(0),
+		cacheValid(0) {
 	}
 #endif
 } spIkConstraint;
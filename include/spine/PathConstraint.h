@@ -42,6 +42,7 @@ extern "C" {
 #endif
 
 struct spSkeleton;
+struct _spPathSample;
 
 typedef struct spPathConstraint {
 	spPathConstraintData* const data;
@@ -67,6 +68,17 @@ typedef struct spPathConstraint {
 
 	float segments[10];
 
+	/* Constant speed paths: world vertices the curve lengths were computed from, the per curve arc length
+	 * tables (10 entries each, computed lazily) and the curve samples collected for the position pass. */
+	int lastWorldCount;
+	float* lastWorld;
+
+	int curveSegmentsCount;
+	float* curveSegments;
+
+	int samplesCount;
+	struct _spPathSample* samples;
+
 #ifdef __cplusplus
 	spPathConstraint() :
 		data(0),
@@ -86,7 +98,13 @@ typedef struct spPathConstraint {
 		curvesCount(0),
 		curves(0),
 		lengthsCount(0),
-		lengths(0) {
+		lengths(0),
+		lastWorldCount(0),
+		lastWorld(0),
+		curveSegmentsCount(0),
+		curveSegments(0),
+		samplesCount(0),
+		samples(0) {
 	}
 #endif
 } spPathConstraint;
@@ -103,6 +103,11 @@ SP_API void spSkeleton_dispose (spSkeleton* self);
 SP_API void spSkeleton_updateCache (spSkeleton* self);
 SP_API void spSkeleton_updateWorldTransform (const spSkeleton* self);
 
+/* Solves every IK constraint in one pass from the pose before IK, then updates the bones and constraints after them in the
+ * update order. Gives the same pose as spSkeleton_updateWorldTransform when, since the last update, only IK mixes, bend
+ * directions or bones updated after the first IK constraint (such as IK targets) changed. */
+SP_API void spSkeleton_updateIkConstraints (const spSkeleton* self);
+
 /* Sets the bones, constraints, and slots to their setup pose values. */
 SP_API void spSkeleton_setToSetupPose (const spSkeleton* self);
 /* Sets the bones and constraints to their setup pose values. */
@@ -147,11 +152,20 @@ SP_API spPathConstraint* spSkeleton_findPathConstraint (const spSkeleton* self,
 
 SP_API void spSkeleton_update (spSkeleton* self, float deltaTime);
 
+/* Copies the local pose of bones and slots, the draw order, constraint mixes and skeleton properties into buffer. Returns
+ * the snapshot size in bytes, if it is larger than capacity the snapshot is incomplete and must be taken again with a larger
+ * buffer. The snapshot references attachments and skins by address, so it is only valid for this skeleton's data. */
+SP_API int spSkeleton_saveState (const spSkeleton* self, void* buffer, int capacity);
+/* Restores a snapshot taken by spSkeleton_saveState. World transforms are not restored, call spSkeleton_updateWorldTransform.
+ * Returns the number of bytes read, or 0 if the buffer does not hold a snapshot of this skeleton. */
+SP_API int spSkeleton_loadState (spSkeleton* self, const void* buffer, int size);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeleton Skeleton;
 #define Skeleton_create(...) spSkeleton_create(__VA_ARGS__)
 #define Skeleton_dispose(...) spSkeleton_dispose(__VA_ARGS__)
 #define Skeleton_updateWorldTransform(...) spSkeleton_updateWorldTransform(__VA_ARGS__)
+#define Skeleton_updateIkConstraints(...) spSkeleton_updateIkConstraints(__VA_ARGS__)
 #define Skeleton_setToSetupPose(...) spSkeleton_setToSetupPose(__VA_ARGS__)
 #define Skeleton_setBonesToSetupPose(...) spSkeleton_setBonesToSetupPose(__VA_ARGS__)
 #define Skeleton_setSlotsToSetupPose(...) spSkeleton_setSlotsToSetupPose(__VA_ARGS__)
@@ -165,6 +179,8 @@ typedef spSkeleton Skeleton;
 #define Skeleton_getAttachmentForSlotIndex(...) spSkeleton_getAttachmentForSlotIndex(__VA_ARGS__)
 #define Skeleton_setAttachment(...) spSkeleton_setAttachment(__VA_ARGS__)
 #define Skeleton_update(...) spSkeleton_update(__VA_ARGS__)
+#define Skeleton_saveState(...) spSkeleton_saveState(__VA_ARGS__)
+#define Skeleton_loadState(...) spSkeleton_loadState(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
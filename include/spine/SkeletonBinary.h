@@ -47,6 +47,16 @@ typedef struct spSkeletonBinary {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
 	const char* const error;
+	/* Reads the skeleton data into a few large blocks that are released together when it is disposed. Attachments are then
+	 * not disposed one by one, so the attachment loader must not rely on disposeAttachment. */
+	int/*bool*/ useArena;
+	/* When not 0, only the skins and animations named here are read (the default skin always is), the others are skipped
+	 * without creating their attachments or timelines. Deform timelines of skipped skins are dropped from the animations read.
+	 * A skin with linked meshes needs the skins of their parents. */
+	const char** skinNames;
+	int skinNamesCount;
+	const char** animationNames;
+	int animationNamesCount;
 } spSkeletonBinary;
 
 SP_API spSkeletonBinary* spSkeletonBinary_createWithLoader (spAttachmentLoader* attachmentLoader);
@@ -55,6 +65,9 @@ SP_API void spSkeletonBinary_dispose (spSkeletonBinary* self);
 
 SP_API spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const unsigned char* binary, const int length);
 SP_API spSkeletonData* spSkeletonBinary_readSkeletonDataFile (spSkeletonBinary* self, const char* path);
+/* Like spSkeletonBinary_readSkeletonData, but names are decoded in place instead of being copied, so the binary is modified.
+ * Use it when the buffer is owned by the caller and no longer needed afterward, eg a private file mapping. */
+SP_API spSkeletonData* spSkeletonBinary_readSkeletonDataInPlace (spSkeletonBinary* self, unsigned char* binary, const int length);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeletonBinary SkeletonBinary;
@@ -63,6 +76,7 @@ typedef spSkeletonBinary SkeletonBinary;
 #define SkeletonBinary_dispose(...) spSkeletonBinary_dispose(__VA_ARGS__)
 #define SkeletonBinary_readSkeletonData(...) spSkeletonBinary_readSkeletonData(__VA_ARGS__)
 #define SkeletonBinary_readSkeletonDataFile(...) spSkeletonBinary_readSkeletonDataFile(__VA_ARGS__)
+#define SkeletonBinary_readSkeletonDataInPlace(...) spSkeletonBinary_readSkeletonDataInPlace(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
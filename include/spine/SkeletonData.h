@@ -90,12 +90,16 @@ SP_API spSkin* spSkeletonData_findSkin (const spSkeletonData* self, const char*
 SP_API spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* eventName);
 
 SP_API spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName);
+SP_API int spSkeletonData_findAnimationIndex (const spSkeletonData* self, const char* animationName);
 
 SP_API spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* constraintName);
+SP_API int spSkeletonData_findIkConstraintIndex (const spSkeletonData* self, const char* constraintName);
 
 SP_API spTransformConstraintData* spSkeletonData_findTransformConstraint (const spSkeletonData* self, const char* constraintName);
+SP_API int spSkeletonData_findTransformConstraintIndex (const spSkeletonData* self, const char* constraintName);
 
 SP_API spPathConstraintData* spSkeletonData_findPathConstraint (const spSkeletonData* self, const char* constraintName);
+SP_API int spSkeletonData_findPathConstraintIndex (const spSkeletonData* self, const char* constraintName);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeletonData SkeletonData;
@@ -108,6 +112,13 @@ typedef spSkeletonData SkeletonData;
 #define SkeletonData_findSkin(...) spSkeletonData_findSkin(__VA_ARGS__)
 #define SkeletonData_findEvent(...) spSkeletonData_findEvent(__VA_ARGS__)
 #define SkeletonData_findAnimation(...) spSkeletonData_findAnimation(__VA_ARGS__)
+#define SkeletonData_findAnimationIndex(...) spSkeletonData_findAnimationIndex(__VA_ARGS__)
+#define SkeletonData_findIkConstraint(...) spSkeletonData_findIkConstraint(__VA_ARGS__)
+#define SkeletonData_findIkConstraintIndex(...) spSkeletonData_findIkConstraintIndex(__VA_ARGS__)
+#define SkeletonData_findTransformConstraint(...) spSkeletonData_findTransformConstraint(__VA_ARGS__)
+#define SkeletonData_findTransformConstraintIndex(...) spSkeletonData_findTransformConstraintIndex(__VA_ARGS__)
+#define SkeletonData_findPathConstraint(...) spSkeletonData_findPathConstraint(__VA_ARGS__)
+#define SkeletonData_findPathConstraintIndex(...) spSkeletonData_findPathConstraintIndex(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONIMAGE_H_
+#define SPINE_SKELETONIMAGE_H_
+
+#include <spine/dll.h>
+#include <spine/SkeletonData.h>
+#include <spine/Atlas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A skeleton image is skeleton data saved as it is laid out in memory, with the offsets of the pointers to relocate. Reading
+ * one copies it into a single arena block and relocates it, nothing is parsed or allocated object by object. Images can only
+ * be read by a runtime built with the same struct layout, pointer size and byte order, other runtimes fail to read them. */
+typedef struct spSkeletonImage {
+	/* Regions of region and mesh attachments are looked up in the atlas by path when an image is read. */
+	spAtlas* atlas;
+	const char* const error;
+} spSkeletonImage;
+
+SP_API spSkeletonImage* spSkeletonImage_create (spAtlas* atlas);
+SP_API void spSkeletonImage_dispose (spSkeletonImage* self);
+
+/* Returns the image of skeleton data read with useArena, its length is stored in length. The image is freed with _spFree.
+ * Returns 0 and sets error if the skeleton data is not entirely in its arena. */
+SP_API unsigned char* spSkeletonImage_writeSkeletonData (spSkeletonImage* self, const spSkeletonData* skeletonData, int* length);
+/* The skeleton data is released with its arena by spSkeletonData_dispose. Returns 0 and sets error if the image was written
+ * by an incompatible runtime or a region is not in the atlas. */
+SP_API spSkeletonData* spSkeletonImage_readSkeletonData (spSkeletonImage* self, const unsigned char* image, const int length);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonImage SkeletonImage;
+#define SkeletonImage_create(...) spSkeletonImage_create(__VA_ARGS__)
+#define SkeletonImage_dispose(...) spSkeletonImage_dispose(__VA_ARGS__)
+#define SkeletonImage_writeSkeletonData(...) spSkeletonImage_writeSkeletonData(__VA_ARGS__)
+#define SkeletonImage_readSkeletonData(...) spSkeletonImage_readSkeletonData(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONIMAGE_H_ */
@@ -48,6 +48,13 @@ typedef struct spSkeletonJson {
 	float scale;
 	spAttachmentLoader* attachmentLoader;
 	const char* const error;
+	/* See spSkeletonBinary. */
+	int/*bool*/ useArena;
+	/* See spSkeletonBinary. */
+	const char** skinNames;
+	int skinNamesCount;
+	const char** animationNames;
+	int animationNamesCount;
 } spSkeletonJson;
 
 SP_API spSkeletonJson* spSkeletonJson_createWithLoader (spAttachmentLoader* attachmentLoader);
@@ -56,6 +63,9 @@ SP_API void spSkeletonJson_dispose (spSkeletonJson* self);
 
 SP_API spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const char* json);
 SP_API spSkeletonData* spSkeletonJson_readSkeletonDataFile (spSkeletonJson* self, const char* path);
+/* Like spSkeletonJson_readSkeletonData, but strings are unescaped in the NUL terminated json instead of being copied, so it is
+ * modified. Use it when the buffer is owned by the caller and no longer needed afterward. */
+SP_API spSkeletonData* spSkeletonJson_readSkeletonDataInPlace (spSkeletonJson* self, char* json);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeletonJson SkeletonJson;
@@ -64,6 +74,7 @@ typedef spSkeletonJson SkeletonJson;
 #define SkeletonJson_dispose(...) spSkeletonJson_dispose(__VA_ARGS__)
 #define SkeletonJson_readSkeletonData(...) spSkeletonJson_readSkeletonData(__VA_ARGS__)
 #define SkeletonJson_readSkeletonDataFile(...) spSkeletonJson_readSkeletonDataFile(__VA_ARGS__)
+#define SkeletonJson_readSkeletonDataInPlace(...) spSkeletonJson_readSkeletonDataInPlace(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
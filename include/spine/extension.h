@@ -90,6 +90,13 @@
 /* Allocates a new char[], assigns it to TO, and copies FROM to it. Can be used on const types. */
 #define MALLOC_STR(TO,FROM) strcpy(CONST_CAST(char*, TO) = (char*)MALLOC(char, strlen(FROM) + 1), FROM)
 
+/* Storage for state that is kept per thread, so skeletons can be loaded on several threads at once. */
+#ifdef _MSC_VER
+#define SP_THREAD_LOCAL __declspec(thread)
+#else
+#define SP_THREAD_LOCAL __thread
+#endif
+
 #define PI 3.1415926535897932385f
 #define PI2 (PI * 2)
 #define DEG_RAD (PI / 180)
@@ -178,8 +185,43 @@ SP_API void _spSetRealloc(void* (*_realloc) (void* ptr, size_t size));
 SP_API void _spSetFree (void (*_free) (void* ptr));
 SP_API void _spSetRandom(float (*_random) ());
 
+/* Number of calls that reached the malloc or realloc function on the calling thread. */
+SP_API int _spGetAllocationCount ();
+
 char* _spReadFile (const char* path, int* length);
 
+/*
+ * Arena
+ */
+
+/* Bump allocator for memory that is released all at once. While an arena is current on a thread, _spMalloc, _spCalloc and
+ * _spRealloc take memory from it and _spFree ignores pointers into it, other pointers are passed through as usual. */
+typedef struct _spArena _spArena;
+
+_spArena* _spArena_create (size_t blockSize);
+void _spArena_dispose (_spArena* self);
+int/*bool*/ _spArena_contains (const _spArena* self, const void* ptr);
+void _spArena_getStats (const _spArena* self, int* blocksCount, size_t* size, int* allocationsCount);
+
+/* The used part of every block can be copied back to back, a pointer into the arena is then found at its offset in the
+ * copy, -1 if it is not in the arena. The offsets keep the arena's alignment. */
+size_t _spArena_getUsedSize (const _spArena* self);
+void _spArena_copyUsed (const _spArena* self, void* data);
+int _spArena_getUsedOffset (const _spArena* self, const void* ptr);
+
+/* Makes the arena current on the calling thread, 0 for none. Returns the previous one. */
+_spArena* _spSetArena (_spArena* arena);
+
+#ifdef SPINE_SHORT_NAMES
+#define _Arena_create(...) _spArena_create(__VA_ARGS__)
+#define _Arena_dispose(...) _spArena_dispose(__VA_ARGS__)
+#define _Arena_contains(...) _spArena_contains(__VA_ARGS__)
+#define _Arena_getStats(...) _spArena_getStats(__VA_ARGS__)
+#define _Arena_getUsedSize(...) _spArena_getUsedSize(__VA_ARGS__)
+#define _Arena_copyUsed(...) _spArena_copyUsed(__VA_ARGS__)
+#define _Arena_getUsedOffset(...) _spArena_getUsedOffset(__VA_ARGS__)
+#endif
+
 
 /*
  * Math utilities
@@ -191,6 +233,73 @@ float _spMath_interpolate(float (*apply) (float a), float start, float end, floa
 float _spMath_pow2_apply(float a);
 float _spMath_pow2out_apply(float a);
 
+/*
+ * Name lookup
+ */
+
+/* Open addressing hash table mapping names to their index in an array. The names are not copied. */
+typedef struct _spNameTable {
+	int namesCount;
+	const char** names;
+	int capacity;
+	int* entries; /* Index into names plus one, 0 for an empty bucket. */
+
+#ifdef __cplusplus
+	_spNameTable() :
+		namesCount(0),
+		names(0),
+		capacity(0),
+		entries(0) {
+	}
+#endif
+} _spNameTable;
+
+/* Takes ownership of names. When a name occurs more than once, the first index is found. */
+void _spNameTable_init (_spNameTable* self, const char** names, int namesCount);
+void _spNameTable_deinit (_spNameTable* self);
+/* Returns -1 if the name was not found. */
+int _spNameTable_find (const _spNameTable* self, const char* name);
+
+/* Returns true if the name is in the list, or if there is no list (names is 0). Used by the loaders' name filters. */
+int/*bool*/ _spContainsName (const char** names, int namesCount, const char* name);
+
+#ifdef SPINE_SHORT_NAMES
+#define _NameTable_init(...) _spNameTable_init(__VA_ARGS__)
+#define _NameTable_deinit(...) _spNameTable_deinit(__VA_ARGS__)
+#define _NameTable_find(...) _spNameTable_find(__VA_ARGS__)
+#define _ContainsName(...) _spContainsName(__VA_ARGS__)
+#endif
+
+/*
+ * State snapshots
+ */
+
+typedef struct _spStateBuffer {
+	char* data;
+	int capacity;
+	int size; /* Bytes written or read so far, may exceed capacity when writing. */
+	int/*bool*/ error; /* Set when a read ran past capacity or found unexpected data. */
+} _spStateBuffer;
+
+void _spStateBuffer_init (_spStateBuffer* self, const void* data, int capacity);
+/* Copies the bytes only while they fit, size always advances so the needed capacity can be reported. */
+void _spStateBuffer_write (_spStateBuffer* self, const void* data, int size);
+/* Returns 0 and sets error if fewer than size bytes remain. */
+int/*bool*/ _spStateBuffer_read (_spStateBuffer* self, void* data, int size);
+void _spStateBuffer_writeInt (_spStateBuffer* self, int value);
+int _spStateBuffer_readInt (_spStateBuffer* self);
+/* Reads an int and sets error if it is not the expected value. */
+void _spStateBuffer_expectInt (_spStateBuffer* self, int expected);
+
+#ifdef SPINE_SHORT_NAMES
+#define _StateBuffer_init(...) _spStateBuffer_init(__VA_ARGS__)
+#define _StateBuffer_write(...) _spStateBuffer_write(__VA_ARGS__)
+#define _StateBuffer_read(...) _spStateBuffer_read(__VA_ARGS__)
+#define _StateBuffer_writeInt(...) _spStateBuffer_writeInt(__VA_ARGS__)
+#define _StateBuffer_readInt(...) _spStateBuffer_readInt(__VA_ARGS__)
+#define _StateBuffer_expectInt(...) _spStateBuffer_expectInt(__VA_ARGS__)
+#endif
+
 /**/
 
 typedef union _spEventQueueItem {
@@ -227,12 +336,23 @@ struct _spAnimationState {
 
 	_spEventQueue* queue;
 
+	/* Open addressing set of property IDs. A bucket is used when its stamp equals propertyIDsStamp, so the set is
+	 * cleared by incrementing the stamp. */
 	int* propertyIDs;
+	unsigned int* propertyIDsStamps;
+	unsigned int propertyIDsStamp;
 	int propertyIDsCount;
 	int propertyIDsCapacity;
 
 	int /*boolean*/ animationsChanged;
 
+	/* Disposed track entries, linked by next, reused by setAnimation and addAnimation. */
+	spTrackEntry* trackEntryPool;
+
+	/* Per track, 0 or one flag per bone followed by one per slot, see spAnimationState_setTrackMask. */
+	unsigned char** trackMasks;
+	int trackMasksCount;
+
 #ifdef __cplusplus
 	_spAnimationState() :
 		super(),
@@ -240,9 +360,14 @@ struct _spAnimationState {
 		events(0),
 		queue(0),
 		propertyIDs(0),
+		propertyIDsStamps(0),
+		propertyIDsStamp(0),
 		propertyIDsCount(0),
 		propertyIDsCapacity(0),
-		animationsChanged(0) {
+		animationsChanged(0),
+		trackEntryPool(0),
+		trackMasks(0),
+		trackMasksCount(0) {
 	}
 #endif
 };
@@ -275,12 +400,16 @@ void _spAttachmentLoader_setUnknownTypeError (spAttachmentLoader* self, spAttach
 void _spAttachment_init (spAttachment* self, const char* name, spAttachmentType type,
 void (*dispose) (spAttachment* self));
 void _spAttachment_deinit (spAttachment* self);
+/* Points an attachment copied from a skeleton image at the static vtable of its type. It must then not be disposed on its
+ * own, only with the arena it is in. Returns 0 for an unknown type. */
+int/*bool*/ _spAttachment_setSharedVtable (spAttachment* self);
 void _spVertexAttachment_init (spVertexAttachment* self);
 void _spVertexAttachment_deinit (spVertexAttachment* self);
 
 #ifdef SPINE_SHORT_NAMES
 #define _Attachment_init(...) _spAttachment_init(__VA_ARGS__)
 #define _Attachment_deinit(...) _spAttachment_deinit(__VA_ARGS__)
+#define _Attachment_setSharedVtable(...) _spAttachment_setSharedVtable(__VA_ARGS__)
 #define _VertexAttachment_deinit(...) _spVertexAttachment_deinit(__VA_ARGS__)
 #endif
 
@@ -292,10 +421,13 @@ void _spTimeline_init (spTimeline* self, spTimelineType type,
 		int* eventsCount, float alpha, spMixPose pose, spMixDirection direction),
 	int (*getPropertyId) (const spTimeline* self));
 void _spTimeline_deinit (spTimeline* self);
+/* Same as _spAttachment_setSharedVtable, for timelines. */
+int/*bool*/ _spTimeline_setSharedVtable (spTimeline* self);
 
 #ifdef SPINE_SHORT_NAMES
 #define _Timeline_init(...) _spTimeline_init(__VA_ARGS__)
 #define _Timeline_deinit(...) _spTimeline_deinit(__VA_ARGS__)
+#define _Timeline_setSharedVtable(...) _spTimeline_setSharedVtable(__VA_ARGS__)
 #endif
 
 /**/
@@ -313,6 +445,31 @@ int _spCurveTimeline_binarySearch (float *values, int valuesLength, float target
 #define _CurveTimeline_binarySearch(...) _spCurveTimeline_binarySearch(__VA_ARGS__)
 #endif
 
+/**/
+
+/* Selects the apply function for the constraint's local/relative mode and its non-zero mixes. */
+void _spTransformConstraint_updateApply (spTransformConstraint* self);
+
+#ifdef SPINE_SHORT_NAMES
+#define _TransformConstraint_updateApply(...) _spTransformConstraint_updateApply(__VA_ARGS__)
+#endif
+
+/**/
+
+/* Builds the name lookup tables used by the find functions. Called by the loaders once all data has been read. */
+void _spSkeletonData_updateIndex (spSkeletonData* self);
+
+/* Hands the arena the skeleton data was loaded into to it, spSkeletonData_dispose then releases the arena instead of freeing
+ * each object. */
+void _spSkeletonData_setArena (spSkeletonData* self, _spArena* arena);
+_spArena* _spSkeletonData_getArena (const spSkeletonData* self);
+
+#ifdef SPINE_SHORT_NAMES
+#define _SkeletonData_updateIndex(...) _spSkeletonData_updateIndex(__VA_ARGS__)
+#define _SkeletonData_setArena(...) _spSkeletonData_setArena(__VA_ARGS__)
+#define _SkeletonData_getArena(...) _spSkeletonData_getArena(__VA_ARGS__)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,7 @@
 #include <spine/SkeletonBounds.h>
 #include <spine/SkeletonData.h>
 #include <spine/SkeletonBinary.h>
+#include <spine/SkeletonImage.h>
 #include <spine/SkeletonJson.h>
 #include <spine/Skin.h>
 #include <spine/Slot.h>
@@ -36,121 +36,761 @@
 #include <spine/extension.h>
 #include <spine/spine.h>
 #include "spine.h"
+#include "spine_server.h"
+#include "spine_cache.h"
+#include "spine_textures.h"
 
+#include "core/engine.h"
+#include "core/hashfuncs.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/io/resource_loader.h"
-#include "scene/resources/texture.h"
+#include "core/io/file_access_pack.h"
 
-typedef Ref<Texture> TextureRef;
+#ifdef TOOLS_ENABLED
+#include "core/io/resource_import.h"
+#endif
+
+#ifdef UNIX_ENABLED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SPINE_IMAGE_VERSION 2
+
+// Header of the files saved by ResourceImporterSpine. It is followed by the source file, then by the image of
+// its skeleton data (see spSkeletonImage), each preceded by its length. The image is empty when it couldn't be
+// written, and is only readable by builds with the same struct layout, the source is read on the others.
+struct SpineImageHeader {
+
+	String atlas_path;
+	uint32_t atlas_hash; // of the atlas file the image was built with
+	String source_type; // "json" or "skel"
+	// comma separated names of the skins and animations imported, empty for all of them
+	String skins;
+	String animations;
+};
+
+// Loads a SpineResource in stages: the atlas, each page texture that isn't loaded lazily, then the skeleton. Everything a
+// load needs is kept here, so loads can be polled from background threads at the same time.
+class ResourceInteractiveLoaderSpine : public ResourceInteractiveLoader {
+
+	GDCLASS(ResourceInteractiveLoaderSpine, ResourceInteractiveLoader);
+
+	String path;
+	String local_path;
+	String atlas_path;
+	uint32_t atlas_hash;
+	// see SpineCache, the atlas and skeleton data are shared with other resources of the same content
+	String atlas_key;
+	bool use_cache;
+	bool atlas_cached;
+	bool data_cached;
+	Ref<Spine::SpineResource> resource;
+	// atlas names whose slashes were replaced, the skeleton is patched to match
+	Array invalid_names;
+	// pages whose texture can't wait to be drawn (see SpineTextures), each loaded by a poll
+	Vector<spAtlasPage *> textures;
+	int stage;
+	Error error;
+	uint64_t start_usec;
+	int start_allocations;
+	// set when path is an image saved by ResourceImporterSpine
+	bool imported;
+	bool from_image;
+	// the resource only serves to build an image, it has no textures and takes no path
+	bool saving_image;
+	SpineImageHeader image_header;
+
+	Error _load_atlas();
+	Error _load_skeleton();
+	spSkeletonData *_read_image(String &r_error);
+
+public:
+	void open(const String &p_path);
+	// builds the skeleton data without loading the page textures and saves it with its source
+	Error save_image(const String &p_path);
+	// only the skins (besides the default one) and animations named are imported, see spSkeletonBinary
+	void set_filter(const String &p_skins, const String &p_animations);
+	// called while the atlas is parsed, the texture is loaded by a later poll
+	void defer_texture(spAtlasPage *p_page);
+
+	virtual void set_local_path(const String &p_local_path);
+	virtual Ref<Resource> get_resource();
+	virtual Error poll();
+	virtual int get_stage() const;
+	virtual int get_stage_count() const;
+	virtual void set_translation_remapped(bool p_remapped);
+
+	ResourceInteractiveLoaderSpine();
+};
 
 void _spAtlasPage_createTexture(spAtlasPage* self, const char* path) {
 
-	TextureRef *ref = memnew(TextureRef);
-	*ref = ResourceLoader::load(path);
-	ERR_FAIL_COND(ref->is_null());
-	self->rendererObject = ref;
-	self->width = (*ref)->get_width();
-	self->height = (*ref)->get_height();
+	if (!SpineTextures::create(self, String::utf8(path)))
+		return;
+
+	// an atlas being loaded in stages has its loader as renderer object. A page without its size in the atlas
+	// can't wait, the uvs of its regions are computed from the texture size right after this.
+	ResourceInteractiveLoaderSpine *loader = static_cast<ResourceInteractiveLoaderSpine *>(self->atlas->rendererObject);
+	if (loader && self->width != 0 && self->height != 0) {
+
+		loader->defer_texture(self);
+		return;
+	}
+	SpineTextures::load(self);
 }
 
 void _spAtlasPage_disposeTexture(spAtlasPage* self) {
 
-	if(TextureRef *ref = static_cast<TextureRef *>(self->rendererObject))
-		memdelete(ref);
+	SpineTextures::dispose(self);
 }
 
 
-char* _spUtil_readFile(const char* p_path, int* p_length) {
+/*
+ * A pretty hacky part of patching Spine files
+ * Preface: If I create spine atlas from images with some deep
+ *			foldres structure (e.g. head/eyes.png, head/face.png, body/torso.png, ets)
+ *			I can get a bit buggy ordering in animations.
+ *			This mostly because of names with slashes in resulting atlas and attachments
+ *			(head/eyes, head/face, body/torso, etc.)
+ * I'm to lazy to make any spine research and have no time for waiting this issue
+ * to be resolved, so I just remember all names with slashes in atlas, replace slashes with
+ * '-' and make same thing with skeleton (.json or .skel) for matching names.
+ *
+ * It works good for me, but may be buggy in your case.
+ * I promice:
+ * - to create issue about this github
+ * - add option to avoid this hacky part available in scons (eg hacky_spine=no)
+ * - may be find actual reason of my buggy animations
+ *
+ */
+
+// Atlas lines are recorded as invalid names when they contain a slash, then every slash is replaced.
+static void _spine_patch_atlas(char *p_data, int p_length, Array &r_invalid_names) {
+
+	int line_start = 0;
+	bool is_invalid = false;
+	for (int i = 0; i <= p_length; i++) {
+
+		if (i < p_length && p_data[i] != '\n') {
+
+			if (p_data[i] == '/')
+				is_invalid = true;
+			continue;
+		}
+
+		if (is_invalid) {
+
+			CharString name;
+			name.resize(i - line_start + 1);
+			int name_length = 0;
+			for (int j = line_start; j < i; j++) {
+
+				if (p_data[j] == '\r')
+					continue;
+				name.ptrw()[name_length++] = p_data[j];
+				if (p_data[j] == '/')
+					p_data[j] = '-';
+			}
+			name.ptrw()[name_length] = 0;
+			r_invalid_names.append(String::utf8(name.get_data(), name_length));
+		}
+		line_start = i + 1;
+		is_invalid = false;
+	}
+}
+
+// Byte trie over the invalid names with Aho-Corasick links, so the skeleton file is patched in one pass
+// whatever the number of names. Edges are kept in a hash map keyed by node and byte.
+class SpineNameTrie {
+
+	struct Node {
+		int parent;
+		uint8_t byte;
+		int depth;
+		int fail;
+		int length; // length of the name ending here, 0 if none
+		int output; // closest node along the fail links where a name ends, -1 if none
+	};
+
+	Vector<Node> nodes;
+	HashMap<uint32_t, int> edges;
+
+	_FORCE_INLINE_ static uint32_t _edge(int p_node, uint8_t p_byte) { return ((uint32_t)p_node << 8) | p_byte; }
+
+	_FORCE_INLINE_ int _child(int p_node, uint8_t p_byte) const {
+
+		const int *child = edges.getptr(_edge(p_node, p_byte));
+		return child ? *child : -1;
+	}
+
+public:
+	void add(const CharString &p_name) {
+
+		int node = 0;
+		for (int i = 0; i < p_name.length(); i++) {
+
+			uint8_t c = p_name[i];
+			int child = _child(node, c);
+			if (child == -1) {
+
+				Node n;
+				n.parent = node;
+				n.byte = c;
+				n.depth = nodes[node].depth + 1;
+				n.fail = 0;
+				n.length = 0;
+				n.output = -1;
+				child = nodes.size();
+				nodes.push_back(n);
+				edges[_edge(node, c)] = child;
+			}
+			node = child;
+		}
+		nodes.ptrw()[node].length = p_name.length();
+	}
+
+	void build() {
+
+		// fail links point to shallower nodes, so resolve them in order of depth (counting sort)
+		int max_depth = 0;
+		for (int i = 0; i < nodes.size(); i++)
+			max_depth = MAX(max_depth, nodes[i].depth);
+		Vector<int> offsets;
+		offsets.resize(max_depth + 2);
+		int *o = offsets.ptrw();
+		for (int i = 0; i < offsets.size(); i++)
+			o[i] = 0;
+		for (int i = 0; i < nodes.size(); i++)
+			o[nodes[i].depth + 1]++;
+		for (int i = 1; i < offsets.size(); i++)
+			o[i] += o[i - 1];
+		Vector<int> order;
+		order.resize(nodes.size());
+		for (int i = 0; i < nodes.size(); i++)
+			order.ptrw()[o[nodes[i].depth]++] = i;
+
+		Node *w = nodes.ptrw();
+		for (int i = 0; i < order.size(); i++) {
+
+			Node &n = w[order[i]];
+			if (n.depth > 1) {
+
+				int fail = w[n.parent].fail;
+				while (fail != 0 && _child(fail, n.byte) == -1)
+					fail = w[fail].fail;
+				int target = _child(fail, n.byte);
+				n.fail = target == -1 ? 0 : target;
+			}
+			n.output = w[n.fail].length ? n.fail : w[n.fail].output;
+		}
+	}
+
+	// replaces the slashes of every invalid name found in the data
+	void patch(char *p_data, int p_length) const {
+
+		const Node *r = nodes.ptr();
+		int node = 0;
+		for (int i = 0; i < p_length; i++) {
+
+			uint8_t c = p_data[i];
+			int child = _child(node, c);
+			while (child == -1 && node != 0) {
+
+				node = r[node].fail;
+				child = _child(node, c);
+			}
+			node = child == -1 ? 0 : child;
+
+			for (int match = r[node].length ? node : r[node].output; match != -1; match = r[match].output) {
+
+				for (int j = i - r[match].length + 1; j <= i; j++) {
+
+					if (p_data[j] == '/')
+						p_data[j] = '-';
+				}
+			}
+		}
+	}
+
+	SpineNameTrie() {
+
+		Node root;
+		root.parent = -1;
+		root.byte = 0;
+		root.depth = 0;
+		root.fail = 0;
+		root.length = 0;
+		root.output = -1;
+		nodes.push_back(root);
+	}
+};
+
+static void _spine_patch_skeleton(char *p_data, int p_length, const Array &p_invalid_names) {
+
+	if (!p_invalid_names.size())
+		return;
+
+	SpineNameTrie trie;
+	for (int i = 0; i < p_invalid_names.size(); i++)
+		trie.add(String(p_invalid_names[i]).utf8());
+	trie.build();
+	trie.patch(p_data, p_length);
+}
+
+// The contents of the file, NUL terminated, to be released with _spFree.
+static char *_spine_read_file(const String &p_path, int *p_length) {
 
-	String str_path = String::utf8(p_path);
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
 	if(!f) {
-		ERR_PRINTS(String("Unable to read file :") + String(p_path));
+		ERR_PRINTS(String("Unable to read file :") + p_path);
 	}
 	ERR_FAIL_COND_V(!f, NULL);
 
 	*p_length = f->get_len();
 
-	char *data = (char *)_spMalloc(*p_length, __FILE__, __LINE__);
-	data = (char *)_spMalloc(*p_length, __FILE__, __LINE__);
-	ERR_FAIL_COND_V(data == NULL, NULL);
+	char *data = (char *)_spMalloc(*p_length + 1, __FILE__, __LINE__);
+	if (data == NULL) {
+		memdelete(f);
+		ERR_FAIL_V(NULL);
+	}
 
 	f->get_buffer((uint8_t *)data, *p_length);
+	data[*p_length] = 0;
+	memdelete(f);
+	return data;
+}
 
-	/*
-	 * A pretty hacky part of patching Spine files
-	 * Preface: If I create spine atlas from images with some deep
-	 *			foldres structure (e.g. head/eyes.png, head/face.png, body/torso.png, ets)
-	 *			I can get a bit buggy ordering in animations.
-	 *			This mostly because of names with slashes in resulting atlas and attachments
-	 *			(head/eyes, head/face, body/torso, etc.)
-	 * I'm to lazy to make any spine research and have no time for waiting this issue
-	 * to be resolved, so I just remember all names with slashes in atlas, replace slashes with
-	 * '-' and make same thing with skeleton (.json or .skel) for matching names.
-	 *
-	 * It works good for me, but may be buggy in your case.
-	 * I promice:
-	 * - to create issue about this github
-	 * - add option to avoid this hacky part available in scons (eg hacky_spine=no)
-	 * - may be find actual reason of my buggy animations
-	 *
-	 */
-
-	Array _sp_invalid_names = Spine::get_invalid_names();
-	if (str_path.ends_with(".atlas")){
-		Array current_string = Array();
-		bool is_invalid = false;
-		for (int i=0; i<*p_length; i++){
-			if (data[i] == '\r') continue;
-			if (data[i] == '\n'){
-				if (is_invalid) {
-					//print_line("Add invalid index: " + current_string);
-					_sp_invalid_names.append(current_string);
-				}
-				current_string = Array();
-				is_invalid = false;
-			} else {
-				current_string.append(data[i]);
-			}
-			if (data[i]=='/') {
-				is_invalid = true;
-				data[i] = '-';
-			}
+char* _spUtil_readFile(const char* p_path, int* p_length) {
+
+	return _spine_read_file(String::utf8(p_path), p_length);
+}
+
+// A private (copy-on-write) mapping of the file, so a .skel is patched and its names decoded in
+// place and nothing but the touched pages is ever copied. Returns NULL when the file can't be
+// mapped (not on disk, eg. inside a pck), the caller then goes through FileAccess.
+static char *_spine_map_file(const String &p_path, int *r_length) {
+
+#ifdef UNIX_ENABLED
+	if (PackedData::get_singleton() && !PackedData::get_singleton()->is_disabled() && PackedData::get_singleton()->has_path(p_path))
+		return NULL;
+
+	String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	int fd = open(path.utf8().get_data(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	void *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	*r_length = st.st_size;
+	return (char *)map;
+#else
+	return NULL;
+#endif
+}
+
+static void _spine_unmap_file(char *p_data, int p_length) {
+
+#ifdef UNIX_ENABLED
+	munmap(p_data, p_length);
+#endif
+}
+
+// Names split from a comma separated list, as the C strings of a loader filter.
+struct SpineNameFilter {
+
+	Vector<CharString> names;
+	Vector<const char *> c_names;
+
+	SpineNameFilter(const String &p_names) {
+
+		Vector<String> split = p_names.split(",", false);
+		for (int i = 0; i < split.size(); i++)
+			names.push_back(split[i].strip_edges().utf8());
+		for (int i = 0; i < names.size(); i++)
+			c_names.push_back(names[i].get_data());
+	}
+
+	// NULL for an empty list, which reads everything
+	const char **get() { return c_names.empty() ? NULL : c_names.ptrw(); }
+	int size() const { return c_names.size(); }
+};
+
+// Reads the skeleton data from the patched contents of a .json (NUL terminated) or .skel file,
+// the .skel is decoded in place. Skins and animations not in the comma separated lists are skipped.
+static spSkeletonData *_spine_read_source(spAtlas *p_atlas, char *p_data, int p_length, bool p_json, const String &p_skins, const String &p_animations, String &r_error) {
+
+	SpineNameFilter skins(p_skins);
+	SpineNameFilter animations(p_animations);
+	spSkeletonData *data;
+	if (p_json) {
+
+		spSkeletonJson *json = spSkeletonJson_create(p_atlas);
+		json->scale = 1;
+		json->useArena = 1;
+		json->skinNames = skins.get();
+		json->skinNamesCount = skins.size();
+		json->animationNames = animations.get();
+		json->animationNamesCount = animations.size();
+		// the buffer is ours and NUL terminated, strings are unescaped in it
+		data = spSkeletonJson_readSkeletonDataInPlace(json, p_data);
+		if (data == NULL)
+			r_error = String::utf8(json->error);
+		spSkeletonJson_dispose(json);
+	} else {
+
+		spSkeletonBinary *bin = spSkeletonBinary_create(p_atlas);
+		bin->scale = 1;
+		bin->useArena = 1;
+		bin->skinNames = skins.get();
+		bin->skinNamesCount = skins.size();
+		bin->animationNames = animations.get();
+		bin->animationNamesCount = animations.size();
+		data = spSkeletonBinary_readSkeletonDataInPlace(bin, (unsigned char *)p_data, p_length);
+		if (data == NULL)
+			r_error = String::utf8(bin->error);
+		spSkeletonBinary_dispose(bin);
+	}
+	return data;
+}
+
+// Opens a file saved by ResourceImporterSpine and reads its header, the source follows.
+static FileAccess *_spine_open_image(const String &p_path, SpineImageHeader &r_header) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!f, NULL);
+
+	uint8_t magic[4];
+	f->get_buffer(magic, 4);
+	if (magic[0] != 'G' || magic[1] != 'D' || magic[2] != 'S' || magic[3] != 'P' || f->get_32() != SPINE_IMAGE_VERSION) {
+
+		memdelete(f);
+		ERR_PRINTS("Unrecognized spine image, it must be reimported: " + p_path);
+		return NULL;
+	}
+	r_header.atlas_path = f->get_pascal_string();
+	r_header.atlas_hash = f->get_32();
+	r_header.source_type = f->get_pascal_string();
+	r_header.skins = f->get_pascal_string();
+	r_header.animations = f->get_pascal_string();
+	return f;
+}
+
+ResourceInteractiveLoaderSpine::ResourceInteractiveLoaderSpine() {
+
+	atlas_hash = 0;
+	use_cache = true;
+	atlas_cached = false;
+	data_cached = false;
+	stage = 0;
+	error = OK;
+	start_usec = 0;
+	start_allocations = 0;
+	imported = false;
+	from_image = false;
+	saving_image = false;
+}
+
+void ResourceInteractiveLoaderSpine::open(const String &p_path) {
+
+	path = p_path;
+	resource.instance();
+	start_usec = OS::get_singleton()->get_ticks_usec();
+	start_allocations = _spGetAllocationCount();
+
+	if (p_path.get_extension() == "spimage") {
+
+		FileAccess *f = _spine_open_image(p_path, image_header);
+		if (!f) {
+			error = ERR_FILE_CORRUPT;
+			return;
 		}
+		memdelete(f);
+		imported = true;
+		atlas_path = image_header.atlas_path;
+	} else {
+
+		atlas_path = p_path.get_basename() + ".atlas";
 	}
-	if (_sp_invalid_names.size() && (str_path.ends_with(".json") || str_path.ends_with(".skel"))){
-		for (int i=0; i<*p_length; i++){
-			if (data[i] != '/') continue;
-			for (int j=0; j<_sp_invalid_names.size(); j++){
-				Array in = _sp_invalid_names[j];
-				int idx = in.find('/');
-				bool match = true;
-				for (int k=0;k<idx;k++){
-					if (i<k) { match=false; break; }
-					if (data[i-k] != (int)(in[idx-k])){ match=false; break; }
-				}
-				if (!match) continue;
+}
 
-				Vector<int> extra_replaces;
-				for (int k=1; k<in.size()-idx;k++){
-					if (i+k >= *p_length){ match=false; break; }
-					if (data[i+k] != (int)(in[idx+k])) { match=false; break; }
-					if (data[i+k] == '/') extra_replaces.push_back(i+k);
-				}
-				if (match){
-					//print_line("Fix invalid index: " + in + ", replaces: " + itos(extra_replaces.size()));
-					data[i] = '-';
-					for (int k=0; k<extra_replaces.size(); k++) data[extra_replaces[k]] = '-';
-					break;
-				}
+void ResourceInteractiveLoaderSpine::set_filter(const String &p_skins, const String &p_animations) {
+
+	image_header.skins = p_skins;
+	image_header.animations = p_animations;
+}
+
+void ResourceInteractiveLoaderSpine::defer_texture(spAtlasPage *p_page) {
+
+	textures.push_back(p_page);
+}
+
+void ResourceInteractiveLoaderSpine::set_local_path(const String &p_local_path) {
+
+	local_path = p_local_path;
+}
+
+Ref<Resource> ResourceInteractiveLoaderSpine::get_resource() {
+
+	return resource;
+}
+
+void ResourceInteractiveLoaderSpine::set_translation_remapped(bool p_remapped) {
+}
+
+int ResourceInteractiveLoaderSpine::get_stage() const {
+
+	return stage;
+}
+
+int ResourceInteractiveLoaderSpine::get_stage_count() const {
+
+	// the textures are known once the atlas is parsed
+	return textures.size() + 2;
+}
+
+Error ResourceInteractiveLoaderSpine::poll() {
+
+	if (error != OK)
+		return error;
+
+	if (stage == 0) {
+
+		error = _load_atlas();
+	} else if (stage <= textures.size()) {
+
+		SpineTextures::load(textures[stage - 1]);
+	} else {
+
+		error = _load_skeleton();
+		if (error == OK)
+			error = ERR_FILE_EOF;
+	}
+
+	if (error != OK && error != ERR_FILE_EOF)
+		resource.unref();
+	stage++;
+	return error;
+}
+
+Error ResourceInteractiveLoaderSpine::_load_atlas() {
+
+	int length;
+	char *data = _spine_read_file(atlas_path, &length);
+	ERR_FAIL_COND_V(data == NULL, ERR_CANT_OPEN);
+
+	atlas_hash = hash_djb2_buffer((const uint8_t *)data, length);
+	if (use_cache) {
+
+		atlas_key = atlas_path.get_base_dir() + ":" + SpineCache::content_key(data, length);
+		resource->atlas = SpineCache::acquire_atlas(atlas_key, &invalid_names);
+		if (resource->atlas != NULL) {
+
+			// its pages are set up already, the next stage is the skeleton
+			_spFree(data);
+			atlas_cached = true;
+			return OK;
+		}
+	}
+	_spine_patch_atlas(data, length, invalid_names);
+	resource->atlas = spAtlas_create(data, length, atlas_path.get_base_dir().utf8().get_data(), this);
+	_spFree(data);
+	if (resource->atlas == NULL) {
+
+		// the pages were disposed with the atlas
+		textures.clear();
+		ERR_PRINTS("Unable to parse atlas: " + atlas_path);
+		return ERR_FILE_CORRUPT;
+	}
+	resource->atlas->rendererObject = NULL;
+	return OK;
+}
+
+Error ResourceInteractiveLoaderSpine::_load_skeleton() {
+
+	Spine::SpineResource *res = resource.ptr();
+	// the pages that can't be loaded lazily are loaded by now, the atlas can be shared
+	if (use_cache && !atlas_cached)
+		res->atlas = SpineCache::add_atlas(atlas_key, atlas_path, res->atlas, invalid_names);
+
+	String load_error;
+	String source_key;
+	if (imported) {
+
+		res->data = _read_image(load_error);
+	} else {
+
+		// json is parsed as a NUL terminated string, which the mapping isn't
+		bool json = path.get_extension() == "json";
+		int length;
+		char *data = json ? NULL : _spine_map_file(path, &length);
+		bool mapped = data != NULL;
+		if (!mapped)
+			data = _spine_read_file(path, &length);
+		ERR_FAIL_COND_V(data == NULL, ERR_CANT_OPEN);
+
+		if (use_cache) {
+
+			source_key = atlas_key + "/" + SpineCache::content_key(data, length);
+			res->data = SpineCache::acquire_skeleton_data(source_key);
+			data_cached = res->data != NULL;
+		}
+		if (!data_cached) {
+
+			_spine_patch_skeleton(data, length, invalid_names);
+			res->data = _spine_read_source(res->atlas, data, length, json, image_header.skins, image_header.animations, load_error);
+		}
+		if (mapped)
+			_spine_unmap_file(data, length);
+		else
+			_spFree(data);
+	}
+	if (use_cache && !data_cached && res->data != NULL) {
+
+		spSkeletonData *data = res->data;
+		// filtered data keeps the hash of the skeleton, it's only shared with loads using the same filter
+		String data_key = atlas_key;
+		if (!image_header.skins.empty() || !image_header.animations.empty())
+			data_key += "?skins=" + image_header.skins + "&animations=" + image_header.animations;
+		res->data = SpineCache::add_skeleton_data(data_key, source_key, path, data);
+		data_cached = res->data != data;
+	}
+	if (res->data == NULL) {
+
+		ERR_PRINTS(path + ": " + load_error);
+		return ERR_FILE_CORRUPT;
+	}
+
+	res->build_name_index();
+	res->state_data = spAnimationStateData_create(res->data);
+	if (!saving_image)
+		res->set_path(local_path.empty() ? path : local_path);
+
+	if (OS::get_singleton()->is_stdout_verbose()) {
+
+		uint64_t finish = OS::get_singleton()->get_ticks_usec();
+		String msg = "Spine resource (" + path + ") loaded" + (data_cached ? " from the cache" : from_image ? " from its image" : "") + " in " + rtos((finish - start_usec) / 1000.0) + " msecs, " + itos(_spGetAllocationCount() - start_allocations) + " allocations";
+		if (_spArena *arena = _spSkeletonData_getArena(res->data)) {
+			int blocks, arena_allocations;
+			size_t size;
+			_spArena_getStats(arena, &blocks, &size, &arena_allocations);
+			msg += " (" + itos(arena_allocations) + " objects, " + itos(size / 1024) + " KiB in " + itos(blocks) + " arena blocks)";
+		}
+		print_line(msg);
+	}
+	return OK;
+}
+
+spSkeletonData *ResourceInteractiveLoaderSpine::_read_image(String &r_error) {
+
+	FileAccess *f = _spine_open_image(path, image_header);
+	if (!f) {
+		r_error = "Unable to open image";
+		return NULL;
+	}
+	int source_length = f->get_32();
+	size_t source_position = f->get_position();
+
+	// the image points to the atlas regions by name but has a copy of their coordinates
+	if (atlas_hash == image_header.atlas_hash) {
+
+		f->seek(source_position + source_length);
+		int image_length = f->get_32();
+		if (image_length > 0) {
+
+			Vector<uint8_t> image;
+			image.resize(image_length);
+			f->get_buffer(image.ptrw(), image_length);
+
+			spSkeletonImage *reader = spSkeletonImage_create(resource->atlas);
+			spSkeletonData *data = spSkeletonImage_readSkeletonData(reader, image.ptr(), image_length);
+			if (data == NULL && OS::get_singleton()->is_stdout_verbose())
+				print_line(path + ": " + String::utf8(reader->error) + " Reading the source instead.");
+			spSkeletonImage_dispose(reader);
+			if (data != NULL) {
+
+				memdelete(f);
+				from_image = true;
+				return data;
 			}
 		}
+	} else if (OS::get_singleton()->is_stdout_verbose()) {
+
+		print_line(path + ": " + atlas_path + " changed since the import. Reading the source instead.");
+	}
 
-		_sp_invalid_names.resize(0);
+	f->seek(source_position);
+	char *data = (char *)_spMalloc(source_length + 1, __FILE__, __LINE__);
+	if (data == NULL) {
+		memdelete(f);
+		ERR_FAIL_V(NULL);
 	}
+	f->get_buffer((uint8_t *)data, source_length);
+	data[source_length] = 0;
 	memdelete(f);
-	return data;
+
+	_spine_patch_skeleton(data, source_length, invalid_names);
+	spSkeletonData *skeleton_data = _spine_read_source(resource->atlas, data, source_length, image_header.source_type == "json", image_header.skins, image_header.animations, r_error);
+	_spFree(data);
+	return skeleton_data;
+}
+
+Error ResourceInteractiveLoaderSpine::save_image(const String &p_path) {
+
+	ERR_FAIL_COND_V(error != OK, error);
+	// the atlas has no textures here, it must not be shared with loaded resources
+	use_cache = false;
+	saving_image = true;
+	Error err = _load_atlas();
+	// the pages keep no texture, the image doesn't need them
+	textures.clear();
+	if (err != OK)
+		return err;
+	err = _load_skeleton();
+	if (err != OK)
+		return err;
+
+	spSkeletonImage *writer = spSkeletonImage_create(resource->atlas);
+	int image_length = 0;
+	unsigned char *image = spSkeletonImage_writeSkeletonData(writer, resource->data, &image_length);
+	if (image == NULL)
+		WARN_PRINTS(path + ": " + String::utf8(writer->error) + " Only the source is saved.");
+	spSkeletonImage_dispose(writer);
+
+	Vector<uint8_t> source = FileAccess::get_file_as_array(path);
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	if (!f) {
+		_spFree(image);
+		ERR_FAIL_V(ERR_CANT_CREATE);
+	}
+
+	f->store_buffer((const uint8_t *)"GDSP", 4);
+	f->store_32(SPINE_IMAGE_VERSION);
+	f->store_pascal_string(atlas_path);
+	f->store_32(atlas_hash);
+	f->store_pascal_string(path.get_extension().to_lower());
+	f->store_pascal_string(image_header.skins);
+	f->store_pascal_string(image_header.animations);
+	f->store_32(source.size());
+	f->store_buffer(source.ptr(), source.size());
+	f->store_32(image_length);
+	if (image != NULL)
+		f->store_buffer(image, image_length);
+	memdelete(f);
+	_spFree(image);
+	return OK;
 }
 
 static void *spine_malloc(size_t p_size) {
@@ -177,52 +817,21 @@ static void spine_free(void *ptr) {
 class ResourceFormatLoaderSpine : public ResourceFormatLoader {
 public:
 
-	virtual RES load(const String &p_path, const String& p_original_path = "", Error *p_err=NULL) {
-		float start = OS::get_singleton()->get_ticks_msec();
-		Spine::SpineResource *res = memnew(Spine::SpineResource);
-		Ref<Spine::SpineResource> ref(res);
-		String p_atlas = p_path.get_basename() + ".atlas";
-		res->atlas = spAtlas_createFromFile(p_atlas.utf8().get_data(), 0);
-		ERR_FAIL_COND_V(res->atlas == NULL, RES());
-
-		if (p_path.get_extension() == "json"){
-			spSkeletonJson *json = spSkeletonJson_create(res->atlas);
-			ERR_FAIL_COND_V(json == NULL, RES());
-			json->scale = 1;
-
-			res->data = spSkeletonJson_readSkeletonDataFile(json, p_path.utf8().get_data());
-			spSkeletonJson_dispose(json);
-#if defined(ERR_FAIL_COND_V_MSG)
-			ERR_FAIL_COND_V_MSG(res->data == NULL, RES(), json->error);
-#else
-			ERR_EXPLAIN(json->error);
-			ERR_FAIL_COND_V(res->data == NULL, RES());
-#endif
-		} else {
-			spSkeletonBinary* bin  = spSkeletonBinary_create(res->atlas);
-			ERR_FAIL_COND_V(bin == NULL, RES());
-			bin->scale = 1;
-			res->data = spSkeletonBinary_readSkeletonDataFile(bin, p_path.utf8().get_data());
-			spSkeletonBinary_dispose(bin);
-#if defined(ERR_FAIL_COND_V_MSG)
-			ERR_FAIL_COND_V_MSG(res->data == NULL, RES(), bin->error);
-#else
-			ERR_EXPLAIN(bin->error);
-			ERR_FAIL_COND_V(res->data == NULL, RES());
-			ERR_FAIL_COND_V_MSG(res->data == NULL, RES(), bin->error);
-#endif
-		}
+	virtual Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_original_path = "", Error *r_error = NULL) {
 
-		res->set_path(p_path);
-		float finish = OS::get_singleton()->get_ticks_msec();
-		// print_line("Spine resource (" + p_path + ") loaded in " + itos(finish-start) + " msecs");
-		return ref;
+		Ref<ResourceInteractiveLoaderSpine> loader;
+		loader.instance();
+		loader->open(p_path);
+		if (r_error)
+			*r_error = OK;
+		return loader;
 	}
 
 	virtual void get_recognized_extensions(List<String> *p_extensions) const {
 		p_extensions->push_back("skel");
 		p_extensions->push_back("json");
 		p_extensions->push_back("atlas");
+		p_extensions->push_back("spimage");
 	}
 
 	virtual bool handles_type(const String& p_type) const {
@@ -233,21 +842,82 @@ public:
 	virtual String get_resource_type(const String &p_path) const {
 
 		String el = p_path.get_extension().to_lower();
-		if (el=="json" || el=="skel")
+		if (el=="json" || el=="skel" || el=="spimage")
 			return "SpineResource";
 		return "";
 	}
 };
 
+#ifdef TOOLS_ENABLED
+// Imports .skel files (and .json ones when spine/import/json is set, since every .json file of the project
+// is then imported) as a .spimage holding their skeleton data ready to be relocated, see SpineImageHeader.
+// The skins and animations options limit what is imported, so unused ones cost neither load time nor memory.
+class ResourceImporterSpine : public ResourceImporter {
+
+	GDCLASS(ResourceImporterSpine, ResourceImporter);
+
+public:
+	virtual String get_importer_name() const { return "spine"; }
+	virtual String get_visible_name() const { return "Spine"; }
+	virtual void get_recognized_extensions(List<String> *p_extensions) const {
+
+		p_extensions->push_back("skel");
+		if (GLOBAL_GET("spine/import/json"))
+			p_extensions->push_back("json");
+	}
+	virtual String get_save_extension() const { return "spimage"; }
+	virtual String get_resource_type() const { return "SpineResource"; }
+
+	virtual int get_preset_count() const { return 0; }
+	virtual String get_preset_name(int p_idx) const { return String(); }
+	virtual void get_import_options(List<ImportOption> *r_options, int p_preset = 0) const {
+
+		// comma separated names, empty to import all of them
+		r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "skins"), ""));
+		r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "animations"), ""));
+	}
+	virtual bool get_option_visibility(const String &p_option, const Map<StringName, Variant> &p_options) const { return true; }
+
+	virtual Error import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = NULL) {
+
+		Ref<ResourceInteractiveLoaderSpine> loader;
+		loader.instance();
+		loader->open(p_source_file);
+		loader->set_filter(p_options["skins"], p_options["animations"]);
+		return loader->save_image(p_save_path + "." + get_save_extension());
+	}
+};
+#endif
+
 static ResourceFormatLoaderSpine *resource_loader_spine = NULL;
+static SpineServer *spine_server = NULL;
 
 void register_spine_types() {
 
 	ClassDB::register_class<Spine>();
 	ClassDB::register_class<Spine::SpineResource>();
+	ClassDB::register_class<SpineServer>();
+	spine_server = memnew(SpineServer);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("SpineServer", SpineServer::get_singleton()));
+	SpineCache::setup();
+	GLOBAL_DEF("spine/textures/lazy_load", true);
+	GLOBAL_DEF("spine/textures/budget_mb", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("spine/textures/budget_mb", PropertyInfo(Variant::INT, "spine/textures/budget_mb", PROPERTY_HINT_RANGE, "0,4096,1"));
+	SpineTextures::setup();
 	resource_loader_spine = memnew( ResourceFormatLoaderSpine );
 	ResourceLoader::add_resource_format_loader(resource_loader_spine);
 
+#ifdef TOOLS_ENABLED
+	GLOBAL_DEF("spine/import/json", false);
+	if (Engine::get_singleton()->is_editor_hint()) {
+
+		Ref<ResourceImporterSpine> importer;
+		importer.instance();
+		ResourceFormatImporter::get_singleton()->add_importer(importer);
+	}
+#endif
+
+	// set once before anything is loaded, Godot's allocator is safe to use from the loading threads
 	_spSetMalloc(spine_malloc);
 	_spSetRealloc(spine_realloc);
 	_spSetFree(spine_free);
@@ -257,6 +927,10 @@ void unregister_spine_types() {
 
 	if (resource_loader_spine)
 		memdelete(resource_loader_spine);
+	if (spine_server)
+		memdelete(spine_server);
+	SpineCache::cleanup();
+	SpineTextures::cleanup();
 
 }
 
@@ -29,6 +29,9 @@
  *****************************************************************************/
 #ifdef MODULE_SPINE_ENABLED
 #include "spine.h"
+#include "spine_server.h"
+#include "spine_cache.h"
+#include "spine_textures.h"
 #include "core/io/resource_loader.h"
 #include "scene/2d/collision_object_2d.h"
 #include "scene/resources/convex_polygon_shape_2d.h"
@@ -42,32 +45,130 @@ Spine::SpineResource::SpineResource() {
 
 	atlas = NULL;
 	data = NULL;
+	state_data = NULL;
 }
 
 Spine::SpineResource::~SpineResource() {
 
-	if (atlas != NULL)
-		spAtlas_dispose(atlas);
+	if (state_data != NULL)
+		spAnimationStateData_dispose(state_data);
 
-	if (data != NULL)
+	// the data points to regions of the atlas, it goes first
+	if (data != NULL && !SpineCache::release_skeleton_data(data))
 		spSkeletonData_dispose(data);
+
+	if (atlas != NULL && !SpineCache::release_atlas(atlas))
+		spAtlas_dispose(atlas);
 }
 
-Array *Spine::invalid_names = NULL;
-Array Spine::get_invalid_names() {
-	if (invalid_names == NULL) {
-		invalid_names = memnew(Array());
-	}
-	return *invalid_names;
+void Spine::SpineResource::build_name_index() {
+
+	bone_names.clear();
+	slot_names.clear();
+	animation_names.clear();
+	ERR_FAIL_COND(data == NULL);
+
+	// iterate backwards so the first of any duplicated names wins, as in spSkeletonData_find*
+	for (int i = data->bonesCount - 1; i >= 0; i--)
+		bone_names[StringName(String::utf8(data->bones[i]->name))] = i;
+	for (int i = data->slotsCount - 1; i >= 0; i--)
+		slot_names[StringName(String::utf8(data->slots[i]->name))] = i;
+	for (int i = data->animationsCount - 1; i >= 0; i--)
+		animation_names[StringName(String::utf8(data->animations[i]->name))] = i;
+}
+
+int Spine::SpineResource::find_bone(const StringName &p_name) const {
+
+	const int *index = bone_names.getptr(p_name);
+	return index ? *index : -1;
+}
+
+int Spine::SpineResource::find_slot(const StringName &p_name) const {
+
+	const int *index = slot_names.getptr(p_name);
+	return index ? *index : -1;
+}
+
+int Spine::SpineResource::find_animation(const StringName &p_name) const {
+
+	const int *index = animation_names.getptr(p_name);
+	return index ? *index : -1;
+}
+
+void Spine::SpineResource::set_default_mix(real_t p_duration) {
+
+	ERR_FAIL_COND(state_data == NULL);
+	state_data->defaultMix = p_duration;
+}
+
+real_t Spine::SpineResource::get_default_mix() const {
+
+	ERR_FAIL_COND_V(state_data == NULL, 0);
+	return state_data->defaultMix;
+}
+
+void Spine::SpineResource::set_mix(const StringName &p_from, const StringName &p_to, real_t p_duration) {
+
+	ERR_FAIL_COND(state_data == NULL);
+	int from = find_animation(p_from);
+	ERR_FAIL_COND(from == -1);
+	int to = find_animation(p_to);
+	ERR_FAIL_COND(to == -1);
+	spAnimationStateData_setMix(state_data, data->animations[from], data->animations[to], p_duration);
+}
+
+real_t Spine::SpineResource::get_mix(const StringName &p_from, const StringName &p_to) const {
+
+	ERR_FAIL_COND_V(state_data == NULL, 0);
+	int from = find_animation(p_from);
+	ERR_FAIL_COND_V(from == -1, 0);
+	int to = find_animation(p_to);
+	ERR_FAIL_COND_V(to == -1, 0);
+	return spAnimationStateData_getMix(state_data, data->animations[from], data->animations[to]);
+}
+
+void Spine::SpineResource::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("set_default_mix", "duration"), &Spine::SpineResource::set_default_mix);
+	ClassDB::bind_method(D_METHOD("get_default_mix"), &Spine::SpineResource::get_default_mix);
+	ClassDB::bind_method(D_METHOD("set_mix", "from", "to", "duration"), &Spine::SpineResource::set_mix);
+	ClassDB::bind_method(D_METHOD("get_mix", "from", "to"), &Spine::SpineResource::get_mix);
 }
 
 void Spine::spine_animation_callback(spAnimationState *p_state, spEventType p_type, spTrackEntry *p_track, spEvent *p_event) {
 
-	((Spine *)p_state->rendererObject)->_on_animation_state_event(p_track->trackIndex, p_type, p_event, 1);
+	Spine *spine = (Spine *)p_state->rendererObject;
+	if (spine->job_running) {
+
+		// running on a SpineServer worker, replay on the main thread
+		DeferredEvent event;
+		event.track = p_track->trackIndex;
+		event.type = p_type;
+		event.event = p_event;
+		event.loop_count = 1;
+		spine->deferred_events.push_back(event);
+		return;
+	}
+	spine->_on_animation_state_event(p_track->trackIndex, p_type, p_event, 1);
 }
 
 void Spine::_on_animation_state_event(int p_track, spEventType p_type, spEvent *p_event, int p_loop_count) {
 
+	if (batch_events) {
+
+		if (p_type == SP_ANIMATION_INTERRUPT || p_type == SP_ANIMATION_DISPOSE)
+			return;
+		// the buffer only grows, it is reused every frame
+		if (event_batch_count == event_batch.size())
+			event_batch.resize(MAX(16, event_batch_count * 2));
+		DeferredEvent &event = event_batch.ptrw()[event_batch_count++];
+		event.track = p_track;
+		event.type = p_type;
+		event.event = p_event;
+		event.loop_count = p_loop_count;
+		return;
+	}
+
 	switch (p_type) {
 		case SP_ANIMATION_START:
 			emit_signal("animation_start", p_track);
@@ -76,6 +177,8 @@ void Spine::_on_animation_state_event(int p_track, spEventType p_type, spEvent *
 			emit_signal("animation_complete", p_track, p_loop_count);
 			break;
 		case SP_ANIMATION_EVENT: {
+			if (!_has_connections("animation_event"))
+				break;
 			Dictionary event;
 			event["name"] = p_event->data->name;
 			event["int"] = p_event->intValue;
@@ -89,8 +192,68 @@ void Spine::_on_animation_state_event(int p_track, spEventType p_type, spEvent *
 	}
 }
 
+bool Spine::_has_connections(const StringName &p_signal) const {
+
+	List<Connection> connections;
+	get_signal_connection_list(p_signal, &connections);
+	return !connections.empty();
+}
+
+void Spine::_flush_event_batch() {
+
+	// keep the frame's events for get_frame_events and collect the next frame into the other buffer
+	Vector<DeferredEvent> events = frame_events;
+	frame_events = event_batch;
+	event_batch = events;
+	frame_event_count = event_batch_count;
+	event_batch_count = 0;
+
+	if (frame_event_count > 0 && _has_connections("animation_events"))
+		emit_signal("animation_events", get_frame_events());
+}
+
+Array Spine::get_frame_events() const {
+
+	static const char *type_names[] = { "start", "interrupt", "end", "complete", "dispose", "event" };
+
+	Array events;
+	events.resize(frame_event_count);
+	for (int i = 0; i < frame_event_count; i++) {
+
+		const DeferredEvent &batched = frame_events[i];
+		Dictionary event;
+		event["track"] = batched.track;
+		event["type"] = type_names[batched.type];
+		if (batched.type == SP_ANIMATION_COMPLETE)
+			event["loop_count"] = batched.loop_count;
+		if (batched.type == SP_ANIMATION_EVENT) {
+
+			event["name"] = batched.event->data->name;
+			event["int"] = batched.event->intValue;
+			event["float"] = batched.event->floatValue;
+			event["string"] = batched.event->stringValue ? batched.event->stringValue : "";
+		}
+		events[i] = event;
+	}
+	return events;
+}
+
+void Spine::set_batch_events(bool p_enable) {
+
+	batch_events = p_enable;
+	event_batch_count = 0;
+	frame_event_count = 0;
+}
+
+bool Spine::is_batch_events() const {
+
+	return batch_events;
+}
+
 void Spine::_spine_dispose() {
 
+	_leave_instance_group();
+
 	if (playing) {
 		// stop first
 		stop();
@@ -98,7 +261,9 @@ void Spine::_spine_dispose() {
 
 	if (state) {
 
-		spAnimationStateData_dispose(state->data);
+		// the shared mix table belongs to the resource, only per-node overrides are ours
+		if (state->data != res->state_data)
+			spAnimationStateData_dispose(state->data);
 		spAnimationState_dispose(state);
 	}
 
@@ -109,6 +274,17 @@ void Spine::_spine_dispose() {
 	skeleton = NULL;
 	res = RES();
 
+	// drop any update still queued on the server
+	job_pending = false;
+
+	fixed_step_time = 0;
+	fixed_step_pose_valid = false;
+	states.clear();
+	job_delta = 0;
+	deferred_events.clear();
+	event_batch_count = 0;
+	frame_event_count = 0;
+
 	for (AttachmentNodes::Element *E = attachment_nodes.front(); E; E = E->next()) {
 
 		AttachmentNode &node = E->get();
@@ -121,16 +297,12 @@ void Spine::_spine_dispose() {
 
 static Ref<Texture> spine_get_texture(spRegionAttachment *attachment) {
 
-	if (Ref<Texture> *ref = static_cast<Ref<Texture> *>(((spAtlasRegion *)attachment->rendererObject)->page->rendererObject))
-		return *ref;
-	return NULL;
+	return SpineTextures::get(((spAtlasRegion *)attachment->rendererObject)->page);
 }
 
 static Ref<Texture> spine_get_texture(spMeshAttachment *attachment) {
 
-	if (Ref<Texture> *ref = static_cast<Ref<Texture> *>(((spAtlasRegion *)attachment->rendererObject)->page->rendererObject))
-		return *ref;
-	return NULL;
+	return SpineTextures::get(((spAtlasRegion *)attachment->rendererObject)->page);
 }
 
 void Spine::_on_fx_draw() {
@@ -145,6 +317,8 @@ void Spine::_on_fx_draw() {
 
 void Spine::_animation_draw() {
 
+	// instanced nodes draw the group leader's pose with their own modulate and flips
+	spSkeleton *skeleton = _get_pose_skeleton();
 	if (skeleton == NULL)
 		return;
 
@@ -355,7 +529,14 @@ void Spine::_animation_draw() {
 	}
 }
 
-void Spine::_animation_process(float p_delta) {
+void Spine::_animation_process(float p_delta, bool p_uncapped) {
+
+	if (_is_instance_follower()) {
+
+		// the leader updates the shared pose and applies it to the members
+		process_delta = 0;
+		return;
+	}
 
 	if (speed_scale == 0)
 		return;
@@ -369,10 +550,169 @@ void Spine::_animation_process(float p_delta) {
 			frames_to_skip = skip_frames;
 		}
 	}
-	spAnimationState_update(state, forward ? process_delta : -process_delta);
+
+	if (threaded_update && !p_uncapped && SpineServer::get_singleton() && is_inside_tree()) {
+
+		job_delta += forward ? process_delta : -process_delta;
+		process_delta = 0;
+		job_pending = true;
+		SpineServer::get_singleton()->queue_flush();
+		return;
+	}
+
+	_animation_update(forward ? process_delta : -process_delta, p_uncapped ? 0 : max_steps_per_frame);
+	_animation_apply_results();
+	process_delta = 0;
+}
+
+void Spine::_animation_update(float p_delta, int p_max_steps) {
+
+	if (fixed_step <= 0) {
+
+		_animation_step(p_delta);
+		return;
+	}
+
+	// every tick advances the state by exactly fixed_step, however the time was split into frames
+	// ticks past p_max_steps stay in fixed_step_time and run in the next frames
+	fixed_step_time += p_delta;
+	int ticks = 0;
+	while (fixed_step_time >= fixed_step && (p_max_steps <= 0 || ticks < p_max_steps)) {
+
+		_animation_step(fixed_step);
+		fixed_step_time -= fixed_step;
+		ticks++;
+	}
+	while (fixed_step_time <= -fixed_step && (p_max_steps <= 0 || ticks < p_max_steps)) {
+
+		_animation_step(-fixed_step);
+		fixed_step_time += fixed_step;
+		ticks++;
+	}
+
+	// while ticks are delayed the last one is shown as is
+	if (fixed_step_interpolation && fixed_step_pose_valid)
+		_blend_fixed_step_pose(MIN(Math::abs(fixed_step_time) / fixed_step, 1.0));
+}
+
+void Spine::_animation_apply_state() {
+
+	// shows the state without advancing it, which runs no tick in fixed step mode, and the stored ticks don't
+	// lead to this pose anymore
+	spAnimationState_update(state, 0);
+	spAnimationState_apply(state, skeleton);
+	spSkeleton_updateWorldTransform(skeleton);
+	fixed_step_pose_valid = false;
+}
+
+void Spine::_animation_step(float p_delta) {
+
+	spAnimationState_update(state, p_delta);
 	spAnimationState_apply(state, skeleton);
 	spSkeleton_updateWorldTransform(skeleton);
 
+	if (fixed_step > 0 && fixed_step_interpolation)
+		_store_fixed_step_pose();
+}
+
+void Spine::_store_fixed_step_pose() {
+
+	int count = skeleton->bonesCount * 6;
+	if (fixed_step_poses.size() != count * 2) {
+
+		fixed_step_poses.resize(count * 2);
+		fixed_step_pose_valid = false;
+	}
+
+	float *prev = fixed_step_poses.ptrw();
+	float *curr = prev + count;
+	if (fixed_step_pose_valid)
+		memcpy(prev, curr, sizeof(float) * count);
+
+	// each axis of the world matrix as an angle and a length, which blend without shrinking a rotating bone and
+	// still rebuild the exact matrix, shear and reflection included
+	for (int i = 0; i < skeleton->bonesCount; i++) {
+
+		const spBone *bone = skeleton->bones[i];
+		float *pose = curr + i * 6;
+		pose[0] = Math::atan2(bone->c, bone->a);
+		pose[1] = Math::sqrt(bone->a * bone->a + bone->c * bone->c);
+		pose[2] = Math::atan2(bone->d, bone->b);
+		pose[3] = Math::sqrt(bone->b * bone->b + bone->d * bone->d);
+		pose[4] = bone->worldX;
+		pose[5] = bone->worldY;
+	}
+
+	if (!fixed_step_pose_valid) {
+
+		memcpy(prev, curr, sizeof(float) * count);
+		fixed_step_pose_valid = true;
+	}
+}
+
+// along the shorter arc
+static float _lerp_angle(float p_from, float p_to, float p_alpha) {
+
+	float difference = Math::fmod(p_to - p_from, (float)(Math_PI * 2));
+	float distance = Math::fmod(2.0f * difference, (float)(Math_PI * 2)) - difference;
+	return p_from + distance * p_alpha;
+}
+
+void Spine::_blend_fixed_step_pose(float p_alpha) {
+
+	// the next tick recomputes world transforms from the local ones, so overwriting them for display is safe
+	int count = skeleton->bonesCount * 6;
+	ERR_FAIL_COND(fixed_step_poses.size() != count * 2);
+	const float *prev = fixed_step_poses.ptr();
+	const float *curr = prev + count;
+
+	for (int i = 0; i < skeleton->bonesCount; i++) {
+
+		spBone *bone = skeleton->bones[i];
+		const float *from = prev + i * 6;
+		const float *to = curr + i * 6;
+		float x_angle = _lerp_angle(from[0], to[0], p_alpha);
+		float x_length = Math::lerp(from[1], to[1], p_alpha);
+		float y_angle = _lerp_angle(from[2], to[2], p_alpha);
+		float y_length = Math::lerp(from[3], to[3], p_alpha);
+		CONST_CAST(float, bone->a) = Math::cos(x_angle) * x_length;
+		CONST_CAST(float, bone->c) = Math::sin(x_angle) * x_length;
+		CONST_CAST(float, bone->b) = Math::cos(y_angle) * y_length;
+		CONST_CAST(float, bone->d) = Math::sin(y_angle) * y_length;
+		CONST_CAST(float, bone->worldX) = Math::lerp(from[4], to[4], p_alpha);
+		CONST_CAST(float, bone->worldY) = Math::lerp(from[5], to[5], p_alpha);
+	}
+}
+
+void Spine::_animation_job() {
+
+	job_running = true;
+	_animation_update(job_delta, max_steps_per_frame);
+	job_running = false;
+	job_delta = 0;
+}
+
+void Spine::_animation_job_finish() {
+
+	job_pending = false;
+
+	if (deferred_events.size() > 0) {
+
+		// signal handlers may call back into the state, so swap the queue out first
+		Vector<DeferredEvent> events = deferred_events;
+		deferred_events.clear();
+		for (int i = 0; i < events.size(); i++) {
+
+			const DeferredEvent &event = events[i];
+			_on_animation_state_event(event.track, event.type, event.event, event.loop_count);
+		}
+	}
+	_animation_apply_results();
+}
+
+void Spine::_animation_apply_results() {
+
+	const spSkeleton *pose = _get_pose_skeleton();
 	for (AttachmentNodes::Element *E = attachment_nodes.front(); E; E = E->next()) {
 
 		AttachmentNode &info = E->get();
@@ -388,13 +728,41 @@ void Spine::_animation_process(float p_delta) {
 				break;
 			continue;
 		}
-		spBone *bone = info.bone;
+		const spBone *bone = pose->bones[info.bone->data->index];
 		node->call("set_position", Vector2(bone->worldX + bone->skeleton->x, -bone->worldY + bone->skeleton->y) + info.ofs);
 		node->call("set_scale", Vector2(spBone_getWorldScaleX(bone), spBone_getWorldScaleY(bone)) * info.scale);
 		node->call("set_rotation", Math::atan2(bone->c, bone->d) + Math::deg2rad(info.rot));
 	}
+	if (batch_events)
+		_flush_event_batch();
 	update();
-	process_delta = 0;
+
+	// the members draw this pose, whether they process or not
+	if (instance_members != NULL && (*instance_members)[0] == this)
+		for (int i = 1; i < instance_members->size(); i++)
+			(*instance_members)[i]->_animation_apply_results();
+}
+
+void Spine::_update_server_registration() {
+
+	SpineServer *server = SpineServer::get_singleton();
+	if (server == NULL)
+		return;
+
+	server->remove_node(this);
+	if (threaded_update && is_inside_tree())
+		server->add_node(this);
+	else if (job_pending) {
+
+		// finish the queued update on the main thread
+		job_pending = false;
+		if (skeleton != NULL) {
+
+			_animation_update(job_delta);
+			_animation_apply_results();
+		}
+		job_delta = 0;
+	}
 }
 
 void Spine::_set_process(bool p_process, bool p_force) {
@@ -485,15 +853,11 @@ bool Spine::_get(const StringName &p_name, Variant &r_ret) const {
 	return true;
 }
 
-float Spine::get_animation_length(String p_animation) const {
+float Spine::get_animation_length(const StringName &p_animation) const {
 	if (state == NULL) return 0;
-	for (int i = 0; i < state->data->skeletonData->animationsCount; i++) {
-		spAnimation *anim = state->data->skeletonData->animations[i];
-		if (anim->name == p_animation) {
-			return anim->duration;
-		}
-	}
-	return 0;
+	int index = res->find_animation(p_animation);
+	if (index == -1) return 0;
+	return state->data->skeletonData->animations[index]->duration;
 }
 
 void Spine::_get_property_list(List<PropertyInfo> *p_list) const {
@@ -560,6 +924,8 @@ void Spine::_notification(int p_what) {
 				set_physics_process(false);
 				set_process(false);
 			}
+			_update_server_registration();
+			_join_instance_group();
 		} break;
 		case NOTIFICATION_READY: {
 
@@ -596,7 +962,13 @@ void Spine::_notification(int p_what) {
 
 		case NOTIFICATION_EXIT_TREE: {
 
+			// a leader hands its state over to the next member before stopping
+			_leave_instance_group();
 			stop_all();
+			if (SpineServer::get_singleton())
+				SpineServer::get_singleton()->remove_node(this);
+			job_pending = false;
+			job_delta = 0;
 		} break;
 	}
 }
@@ -617,7 +989,7 @@ void Spine::set_resource(Ref<Spine::SpineResource> p_data) {
 	skeleton = spSkeleton_create(res->data);
 	root_bone = skeleton->bones[0];
 
-	state = spAnimationState_create(spAnimationStateData_create(skeleton->data));
+	state = spAnimationState_create(res->state_data);
 	state->rendererObject = this;
 	state->listener = spine_animation_callback;
 
@@ -629,6 +1001,7 @@ void Spine::set_resource(Ref<Spine::SpineResource> p_data) {
 		play(current_animation, 1, loop);
 	else
 		reset();
+	_join_instance_group();
 
 	_change_notify();
 }
@@ -652,31 +1025,39 @@ Array Spine::get_animation_names() const {
 	return names;
 }
 
-bool Spine::has_animation(const String &p_name) {
+bool Spine::has_animation(const StringName &p_name) {
 
 	if (skeleton == NULL) return false;
-	spAnimation *animation = spSkeletonData_findAnimation(skeleton->data, p_name.utf8().get_data());
-	return animation != NULL;
+	return res->find_animation(p_name) != -1;
 }
 
 void Spine::set_default_mix(real_t p_duration) {
 
 	ERR_FAIL_COND(state == NULL);
 	ERR_FAIL_COND(p_duration <= 0.0f);
-	state->data->defaultMix = p_duration;
+	_get_local_state_data()->defaultMix = p_duration;
 }
 
 void Spine::mix(const String &p_from, const String &p_to, real_t p_duration) {
 
 	ERR_FAIL_COND(state == NULL);
-	spAnimationStateData_setMixByName(state->data, p_from.utf8().get_data(), p_to.utf8().get_data(), p_duration);
+	spAnimationStateData_setMixByName(_get_local_state_data(), p_from.utf8().get_data(), p_to.utf8().get_data(), p_duration);
 }
 
-bool Spine::play(const String &p_name, bool p_loop, int p_track, int p_delay) {
+spAnimationStateData *Spine::_get_local_state_data() {
+
+	// layer per-node mixes over the resource's table the first time this node changes one
+	if (state->data == res->state_data)
+		CONST_CAST(spAnimationStateData *, state->data) = spAnimationStateData_createOverlay(res->state_data);
+	return state->data;
+}
+
+bool Spine::play(const StringName &p_name, bool p_loop, int p_track, int p_delay) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	spAnimation *animation = spSkeletonData_findAnimation(skeleton->data, p_name.utf8().get_data());
-	ERR_FAIL_COND_V(animation == NULL, false);
+	int index = res->find_animation(p_name);
+	ERR_FAIL_COND_V(index == -1, false);
+	spAnimation *animation = skeleton->data->animations[index];
 	spTrackEntry *entry = spAnimationState_setAnimation(state, p_track, animation, p_loop);
 	entry->delay = p_delay;
 	current_animation = p_name;
@@ -686,18 +1067,23 @@ bool Spine::play(const String &p_name, bool p_loop, int p_track, int p_delay) {
 
 	_set_process(true);
 	playing = true;
-	// update frame
-	if (!is_active())
+	// update frame, a zero delta runs no tick in fixed step mode
+	if (fixed_step > 0) {
+
+		_animation_apply_state();
+		_animation_apply_results();
+	} else if (!is_active())
 		_animation_process(0);
 
 	return true;
 }
 
-bool Spine::add(const String &p_name, bool p_loop, int p_track, int p_delay) {
+bool Spine::add(const StringName &p_name, bool p_loop, int p_track, int p_delay) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	spAnimation *animation = spSkeletonData_findAnimation(skeleton->data, p_name.utf8().get_data());
-	ERR_FAIL_COND_V(animation == NULL, false);
+	int index = res->find_animation(p_name);
+	ERR_FAIL_COND_V(index == -1, false);
+	spAnimation *animation = skeleton->data->animations[index];
 	spTrackEntry *entry = spAnimationState_addAnimation(state, p_track, animation, p_loop, p_delay);
 
 	_set_process(true);
@@ -756,6 +1142,136 @@ String Spine::get_current_animation(int p_track = 0) {
 	return entry->animation->name;
 }
 
+int Spine::get_current_animation_index(int p_track) const {
+
+	ERR_FAIL_COND_V(state == NULL, -1);
+	spTrackEntry *entry = spAnimationState_getCurrent(state, p_track);
+	if (entry == NULL)
+		return -1;
+	const spSkeletonData *data = skeleton->data;
+	for (int i = 0; i < data->animationsCount; i++) {
+
+		if (data->animations[i] == entry->animation)
+			return i;
+	}
+	return -1;
+}
+
+float Spine::get_track_time(int p_track) const {
+
+	ERR_FAIL_COND_V(state == NULL, 0);
+	spTrackEntry *entry = spAnimationState_getCurrent(state, p_track);
+	return entry ? entry->trackTime : 0;
+}
+
+float Spine::get_animation_time(int p_track) const {
+
+	ERR_FAIL_COND_V(state == NULL, 0);
+	spTrackEntry *entry = spAnimationState_getCurrent(state, p_track);
+	return entry ? spTrackEntry_getAnimationTime(entry) : 0;
+}
+
+float Spine::get_mix_alpha(int p_track) const {
+
+	ERR_FAIL_COND_V(state == NULL, 0);
+	spTrackEntry *entry = spAnimationState_getCurrent(state, p_track);
+	if (entry == NULL)
+		return 0;
+	if (entry->mixingFrom == NULL || entry->mixDuration <= 0)
+		return 1;
+	return MIN(1, entry->mixTime / entry->mixDuration);
+}
+
+int Spine::find_bone(const StringName &p_bone_name) const {
+
+	ERR_FAIL_COND_V(skeleton == NULL, -1);
+	return res->find_bone(p_bone_name);
+}
+
+int Spine::find_slot(const StringName &p_slot_name) const {
+
+	ERR_FAIL_COND_V(skeleton == NULL, -1);
+	return res->find_slot(p_slot_name);
+}
+
+static _FORCE_INLINE_ Transform2D spine_bone_transform(const spBone *p_bone) {
+
+	// spine is y up
+	return Transform2D(p_bone->a, -p_bone->c, -p_bone->b, p_bone->d, p_bone->worldX + p_bone->skeleton->x, -p_bone->worldY + p_bone->skeleton->y);
+}
+
+Transform2D Spine::get_bone_transform(int p_bone) const {
+
+	ERR_FAIL_COND_V(skeleton == NULL, Transform2D());
+	ERR_FAIL_INDEX_V(p_bone, skeleton->bonesCount, Transform2D());
+	return spine_bone_transform(_get_pose_skeleton()->bones[p_bone]);
+}
+
+PoolVector2Array Spine::get_bone_transforms(const PoolIntArray &p_bones) const {
+
+	PoolVector2Array result;
+	ERR_FAIL_COND_V(skeleton == NULL, result);
+	int count = p_bones.size();
+	result.resize(count * 3);
+	{
+		PoolIntArray::Read r = p_bones.read();
+		PoolVector2Array::Write w = result.write();
+		for (int i = 0; i < count; i++) {
+
+			int bone = r[i];
+			ERR_CONTINUE(bone < 0 || bone >= skeleton->bonesCount);
+			Transform2D xform = spine_bone_transform(_get_pose_skeleton()->bones[bone]);
+			w[i * 3 + 0] = xform.elements[0];
+			w[i * 3 + 1] = xform.elements[1];
+			w[i * 3 + 2] = xform.elements[2];
+		}
+	}
+	return result;
+}
+
+void Spine::set_track_mask(int p_track, const PoolStringArray &p_bones, bool p_include_children) {
+
+	ERR_FAIL_COND(state == NULL);
+	ERR_FAIL_COND(p_track < 0);
+	const spSkeletonData *data = skeleton->data;
+	Vector<uint8_t> bone_mask;
+	bone_mask.resize(data->bonesCount);
+	uint8_t *bones = bone_mask.ptrw();
+	for (int i = 0; i < data->bonesCount; i++)
+		bones[i] = 0;
+	{
+		PoolStringArray::Read r = p_bones.read();
+		for (int i = 0; i < p_bones.size(); i++) {
+
+			int index = res->find_bone(r[i]);
+			ERR_CONTINUE(index < 0);
+			bones[index] = 1;
+		}
+	}
+	// parents always precede their children in the skeleton data
+	if (p_include_children) {
+		for (int i = 0; i < data->bonesCount; i++) {
+
+			const spBoneData *parent = data->bones[i]->parent;
+			if (parent != NULL && bones[parent->index])
+				bones[i] = 1;
+		}
+	}
+	Vector<uint8_t> slot_mask;
+	slot_mask.resize(data->slotsCount);
+	uint8_t *slots = slot_mask.ptrw();
+	for (int i = 0; i < data->slotsCount; i++)
+		slots[i] = bones[data->slots[i]->boneData->index];
+
+	spAnimationState_setTrackMask(state, p_track, bones, slots);
+}
+
+void Spine::clear_track_mask(int p_track) {
+
+	ERR_FAIL_COND(state == NULL);
+	spAnimationState_setTrackMask(state, p_track, NULL, NULL);
+}
+
 void Spine::stop_all() {
 
 	stop();
@@ -768,14 +1284,12 @@ void Spine::reset() {
 		return;
 	}
 	spSkeleton_setToSetupPose(skeleton);
-	spAnimationState_update(state, 0);
-	spAnimationState_apply(state, skeleton);
-	spSkeleton_updateWorldTransform(skeleton);
+	_animation_apply_state();
 }
 
 void Spine::seek(float p_pos) {
 
-	_animation_process(p_pos - current_pos);
+	_animation_process(p_pos - current_pos, true);
 }
 
 float Spine::tell() const {
@@ -853,7 +1367,11 @@ bool Spine::is_flip_y() const {
 bool Spine::set_skin(const String &p_name) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	return spSkeleton_setSkinByName(skeleton, p_name.utf8().get_data()) ? true : false;
+	if (!spSkeleton_setSkinByName(skeleton, p_name.utf8().get_data()))
+		return false;
+	// load the pages of the skin now rather than as its attachments show up
+	SpineTextures::load_skin(skeleton->skin);
+	return true;
 }
 
 void Spine::set_duration(float p_duration) {
@@ -942,11 +1460,12 @@ Dictionary Spine::get_attachment(const String &p_slot_name, const String &p_atta
 	return dict;
 }
 
-Dictionary Spine::get_bone(const String &p_bone_name) const {
+Dictionary Spine::get_bone(const StringName &p_bone_name) const {
 
 	ERR_FAIL_COND_V(skeleton == NULL, Variant());
-	spBone *bone = spSkeleton_findBone(skeleton, p_bone_name.utf8().get_data());
-	ERR_FAIL_COND_V(bone == NULL, Variant());
+	int index = res->find_bone(p_bone_name);
+	ERR_FAIL_COND_V(index == -1, Variant());
+	spBone *bone = skeleton->bones[index];
 	Dictionary dict;
 	dict["x"] = bone->x;
 	dict["y"] = bone->y;
@@ -971,35 +1490,44 @@ Dictionary Spine::get_bone(const String &p_bone_name) const {
 	return dict;
 }
 
-Dictionary Spine::get_slot(const String &p_slot_name) const {
+Dictionary Spine::get_slot(const StringName &p_slot_name) const {
 
 	ERR_FAIL_COND_V(skeleton == NULL, Variant());
-	spSlot *slot = spSkeleton_findSlot(skeleton, p_slot_name.utf8().get_data());
-	ERR_FAIL_COND_V(slot == NULL, Variant());
+	int index = res->find_slot(p_slot_name);
+	ERR_FAIL_COND_V(index == -1, Variant());
+	spSlot *slot = skeleton->slots[index];
 	Dictionary dict;
 	dict["color"] = Color(slot->color.r, slot->color.g, slot->color.b, slot->color.a);
 	return dict;
 }
 
-bool Spine::set_attachment(const String &p_slot_name, const Variant &p_attachment) {
+bool Spine::set_attachment(const StringName &p_slot_name, const Variant &p_attachment) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	if (p_attachment.get_type() == Variant::STRING)
-		return spSkeleton_setAttachment(skeleton, p_slot_name.utf8().get_data(), ((const String)p_attachment).utf8().get_data()) != 0;
-	else
-		return spSkeleton_setAttachment(skeleton, p_slot_name.utf8().get_data(), NULL) != 0;
+	int index = res->find_slot(p_slot_name);
+	if (index == -1)
+		return false;
+	spAttachment *attachment = NULL;
+	if (p_attachment.get_type() == Variant::STRING) {
+		attachment = spSkeleton_getAttachmentForSlotIndex(skeleton, index, ((const String)p_attachment).utf8().get_data());
+		if (attachment == NULL)
+			return false;
+	}
+	spSlot_setAttachment(skeleton->slots[index], attachment);
+	return true;
 }
 
-bool Spine::has_attachment_node(const String &p_bone_name, const Variant &p_node) {
+bool Spine::has_attachment_node(const StringName &p_bone_name, const Variant &p_node) {
 
 	return false;
 }
 
-bool Spine::add_attachment_node(const String &p_bone_name, const Variant &p_node, const Vector2 &p_ofs, const Vector2 &p_scale, const real_t p_rot) {
+bool Spine::add_attachment_node(const StringName &p_bone_name, const Variant &p_node, const Vector2 &p_ofs, const Vector2 &p_scale, const real_t p_rot) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	spBone *bone = spSkeleton_findBone(skeleton, p_bone_name.utf8().get_data());
-	ERR_FAIL_COND_V(bone == NULL, false);
+	int index = res->find_bone(p_bone_name);
+	ERR_FAIL_COND_V(index == -1, false);
+	spBone *bone = skeleton->bones[index];
 	Object *obj = p_node;
 	ERR_FAIL_COND_V(obj == NULL, false);
 	Node2D *node = Object::cast_to<Node2D>(obj);
@@ -1033,11 +1561,12 @@ bool Spine::add_attachment_node(const String &p_bone_name, const Variant &p_node
 	return true;
 }
 
-bool Spine::remove_attachment_node(const String &p_bone_name, const Variant &p_node) {
+bool Spine::remove_attachment_node(const StringName &p_bone_name, const Variant &p_node) {
 
 	ERR_FAIL_COND_V(skeleton == NULL, false);
-	spBone *bone = spSkeleton_findBone(skeleton, p_bone_name.utf8().get_data());
-	ERR_FAIL_COND_V(bone == NULL, false);
+	int index = res->find_bone(p_bone_name);
+	ERR_FAIL_COND_V(index == -1, false);
+	spBone *bone = skeleton->bones[index];
 	Object *obj = p_node;
 	ERR_FAIL_COND_V(obj == NULL, false);
 	Node2D *node = Object::cast_to<Node2D>(obj);
@@ -1116,6 +1645,176 @@ Spine::AnimationProcessMode Spine::get_animation_process_mode() const {
 	return animation_process_mode;
 }
 
+void Spine::set_threaded_update(bool p_enable) {
+
+	if (threaded_update == p_enable)
+		return;
+
+	threaded_update = p_enable;
+	_update_server_registration();
+}
+
+bool Spine::is_threaded_update() const {
+
+	return threaded_update;
+}
+
+void Spine::set_fixed_step(float p_step) {
+
+	ERR_FAIL_COND(p_step < 0);
+	fixed_step = p_step;
+	fixed_step_time = 0;
+	fixed_step_pose_valid = false;
+}
+
+float Spine::get_fixed_step() const {
+
+	return fixed_step;
+}
+
+void Spine::set_max_steps_per_frame(int p_steps) {
+
+	ERR_FAIL_COND(p_steps < 0);
+	max_steps_per_frame = p_steps;
+}
+
+int Spine::get_max_steps_per_frame() const {
+
+	return max_steps_per_frame;
+}
+
+void Spine::_write_state(Vector<uint8_t> &r_buffer) const {
+
+	// node state, then the skeleton and animation state snapshots; retried once if the buffer was too small
+	for (int attempt = 0; attempt < 2; attempt++) {
+
+		int capacity = r_buffer.size();
+		uint8_t *data = r_buffer.ptrw();
+		int size = sizeof(double);
+		if (size <= capacity)
+			memcpy(data, &fixed_step_time, sizeof(double));
+		size += spSkeleton_saveState(skeleton, size <= capacity ? data + size : NULL, MAX(0, capacity - size));
+		size += spAnimationState_saveState(state, size <= capacity ? data + size : NULL, MAX(0, capacity - size));
+		if (size <= capacity)
+			return;
+		r_buffer.resize(size);
+	}
+}
+
+bool Spine::_read_state(const Vector<uint8_t> &p_buffer) {
+
+	if (p_buffer.size() < (int)sizeof(double))
+		return false;
+
+	const uint8_t *data = p_buffer.ptr();
+	int size = sizeof(double);
+	int read = spSkeleton_loadState(skeleton, data + size, p_buffer.size() - size);
+	ERR_FAIL_COND_V(read == 0, false);
+	size += read;
+	read = spAnimationState_loadState(state, data + size, p_buffer.size() - size);
+	ERR_FAIL_COND_V(read == 0, false);
+	memcpy(&fixed_step_time, data, sizeof(double));
+
+	fixed_step_pose_valid = false;
+	spSkeleton_updateWorldTransform(skeleton);
+	return true;
+}
+
+void Spine::save_state(int p_slot) {
+
+	ERR_FAIL_COND(skeleton == NULL);
+	ERR_FAIL_COND(p_slot < 0);
+	if (p_slot >= states.size())
+		states.resize(p_slot + 1);
+	_write_state(states.ptrw()[p_slot]);
+}
+
+bool Spine::load_state(int p_slot) {
+
+	ERR_FAIL_COND_V(skeleton == NULL, false);
+	ERR_FAIL_INDEX_V(p_slot, states.size(), false);
+	if (!_read_state(states[p_slot]))
+		return false;
+	_animation_apply_results();
+	return true;
+}
+
+void Spine::_join_instance_group() {
+
+	if (instance_members != NULL || instance_group == StringName() || res.is_null() || skeleton == NULL || !is_inside_tree())
+		return;
+
+	instance_members = &res->instance_groups[instance_group];
+	instance_members->push_back(this);
+	update();
+}
+
+void Spine::_leave_instance_group() {
+
+	if (instance_members == NULL)
+		return;
+
+	Vector<Spine *> *members = instance_members;
+	instance_members = NULL;
+	int idx = members->find(this);
+	ERR_FAIL_COND(idx == -1);
+	Spine *leader = (*members)[0];
+	members->remove(idx);
+
+	// whoever takes over an animation state continues from the shared pose, and plays it as the leader did:
+	// members never needed play() of their own
+	Vector<uint8_t> buffer;
+	Spine *heir = leader != this ? this : members->empty() ? NULL : (*members)[0];
+	if (heir != NULL) {
+
+		leader->_write_state(buffer);
+		heir->_read_state(buffer);
+		heir->playing = leader->playing;
+		heir->current_animation = leader->current_animation;
+		heir->_set_process(leader->processing);
+	}
+
+	if (members->empty())
+		res->instance_groups.erase(instance_group);
+	update();
+}
+
+void Spine::set_instance_group(const StringName &p_group) {
+
+	if (instance_group == p_group)
+		return;
+
+	_leave_instance_group();
+	instance_group = p_group;
+	_join_instance_group();
+}
+
+StringName Spine::get_instance_group() const {
+
+	return instance_group;
+}
+
+bool Spine::is_instance_leader() const {
+
+	return instance_members != NULL && (*instance_members)[0] == this;
+}
+
+void Spine::clear_states() {
+
+	states.clear();
+}
+
+void Spine::set_fixed_step_interpolation(bool p_enable) {
+
+	fixed_step_interpolation = p_enable;
+	fixed_step_pose_valid = false;
+}
+
+bool Spine::is_fixed_step_interpolation() const {
+
+	return fixed_step_interpolation;
+}
+
 void Spine::set_fx_slot_prefix(const String &p_prefix) {
 
 	fx_slot_prefix = p_prefix.utf8();
@@ -1225,6 +1924,16 @@ void Spine::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_playing", "track"), &Spine::is_playing, DEFVAL(0));
 
 	ClassDB::bind_method(D_METHOD("get_current_animation", "p_track"), &Spine::get_current_animation, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_current_animation_index", "track"), &Spine::get_current_animation_index, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_track_time", "track"), &Spine::get_track_time, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_animation_time", "track"), &Spine::get_animation_time, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_mix_alpha", "track"), &Spine::get_mix_alpha, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("find_bone", "bone_name"), &Spine::find_bone);
+	ClassDB::bind_method(D_METHOD("find_slot", "slot_name"), &Spine::find_slot);
+	ClassDB::bind_method(D_METHOD("get_bone_transform", "bone"), &Spine::get_bone_transform);
+	ClassDB::bind_method(D_METHOD("get_bone_transforms", "bones"), &Spine::get_bone_transforms);
+	ClassDB::bind_method(D_METHOD("set_track_mask", "track", "bones", "include_children"), &Spine::set_track_mask, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("clear_track_mask", "track"), &Spine::clear_track_mask);
 	ClassDB::bind_method(D_METHOD("stop_all"), &Spine::stop_all);
 	ClassDB::bind_method(D_METHOD("reset"), &Spine::reset);
 	ClassDB::bind_method(D_METHOD("seek", "pos"), &Spine::seek);
@@ -1245,6 +1954,23 @@ void Spine::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_duration"), &Spine::get_duration);
 	ClassDB::bind_method(D_METHOD("set_animation_process_mode", "mode"), &Spine::set_animation_process_mode);
 	ClassDB::bind_method(D_METHOD("get_animation_process_mode"), &Spine::get_animation_process_mode);
+	ClassDB::bind_method(D_METHOD("set_threaded_update", "enable"), &Spine::set_threaded_update);
+	ClassDB::bind_method(D_METHOD("is_threaded_update"), &Spine::is_threaded_update);
+	ClassDB::bind_method(D_METHOD("set_batch_events", "enable"), &Spine::set_batch_events);
+	ClassDB::bind_method(D_METHOD("is_batch_events"), &Spine::is_batch_events);
+	ClassDB::bind_method(D_METHOD("get_frame_events"), &Spine::get_frame_events);
+	ClassDB::bind_method(D_METHOD("save_state", "slot"), &Spine::save_state, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("load_state", "slot"), &Spine::load_state, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("clear_states"), &Spine::clear_states);
+	ClassDB::bind_method(D_METHOD("set_instance_group", "group"), &Spine::set_instance_group);
+	ClassDB::bind_method(D_METHOD("get_instance_group"), &Spine::get_instance_group);
+	ClassDB::bind_method(D_METHOD("is_instance_leader"), &Spine::is_instance_leader);
+	ClassDB::bind_method(D_METHOD("set_fixed_step", "step"), &Spine::set_fixed_step);
+	ClassDB::bind_method(D_METHOD("get_fixed_step"), &Spine::get_fixed_step);
+	ClassDB::bind_method(D_METHOD("set_fixed_step_interpolation", "enable"), &Spine::set_fixed_step_interpolation);
+	ClassDB::bind_method(D_METHOD("is_fixed_step_interpolation"), &Spine::is_fixed_step_interpolation);
+	ClassDB::bind_method(D_METHOD("set_max_steps_per_frame", "steps"), &Spine::set_max_steps_per_frame);
+	ClassDB::bind_method(D_METHOD("get_max_steps_per_frame"), &Spine::get_max_steps_per_frame);
 	ClassDB::bind_method(D_METHOD("get_skeleton"), &Spine::get_skeleton);
 	ClassDB::bind_method(D_METHOD("get_attachment", "slot_name", "attachment_name"), &Spine::get_attachment);
 	ClassDB::bind_method(D_METHOD("get_bone", "bone_name"), &Spine::get_bone);
@@ -1279,6 +2005,12 @@ void Spine::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Fixed,Idle"), "set_animation_process_mode", "get_animation_process_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed", "get_speed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "threaded_update"), "set_threaded_update", "is_threaded_update");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batch_events"), "set_batch_events", "is_batch_events");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "fixed_step", PROPERTY_HINT_RANGE, "0,1,0.001"), "set_fixed_step", "get_fixed_step");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "fixed_step_interpolation"), "set_fixed_step_interpolation", "is_fixed_step_interpolation");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_steps_per_frame", PROPERTY_HINT_RANGE, "0,64,1"), "set_max_steps_per_frame", "get_max_steps_per_frame");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "instance_group"), "set_instance_group", "get_instance_group");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "skip_frames", PROPERTY_HINT_RANGE, "0, 100, 1"), "set_skip_frames", "get_skip_frames");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_bones"), "set_debug_bones", "is_debug_bones");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_attachment_region"), "set_debug_attachment_region", "is_debug_attachment_region");
@@ -1297,6 +2029,7 @@ void Spine::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("animation_complete", PropertyInfo(Variant::INT, "track"), PropertyInfo(Variant::INT, "loop_count")));
 	ADD_SIGNAL(MethodInfo("animation_event", PropertyInfo(Variant::INT, "track"), PropertyInfo(Variant::DICTIONARY, "event")));
 	ADD_SIGNAL(MethodInfo("animation_end", PropertyInfo(Variant::INT, "track")));
+	ADD_SIGNAL(MethodInfo("animation_events", PropertyInfo(Variant::ARRAY, "events")));
 
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_FIXED);
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_IDLE);
@@ -1416,10 +2149,30 @@ Spine::Spine()
 	modulate = Color(1, 1, 1, 1);
 	flip_x = false;
 	flip_y = false;
+
+	threaded_update = false;
+	job_pending = false;
+	job_running = false;
+	job_delta = 0;
+
+	batch_events = false;
+	event_batch_count = 0;
+	frame_event_count = 0;
+
+	fixed_step = 0;
+	fixed_step_interpolation = false;
+	fixed_step_time = 0;
+	fixed_step_pose_valid = false;
+	max_steps_per_frame = 8;
+
+	instance_members = NULL;
 }
 
 Spine::~Spine() {
 
+	if (SpineServer::get_singleton())
+		SpineServer::get_singleton()->remove_node(this);
+
 	// cleanup
 	_spine_dispose();
 }
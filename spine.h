@@ -36,6 +36,8 @@
 #include <spine/spine.h>
 #include "spine_batcher.h"
 #include "core/array.h"
+#include "core/hash_map.h"
+#include "core/map.h"
 
 class CollisionObject2D;
 
@@ -58,6 +60,12 @@ public:
 
 		GDCLASS(SpineResource, Resource);
 
+		HashMap<StringName, int> bone_names;
+		HashMap<StringName, int> slot_names;
+		HashMap<StringName, int> animation_names;
+
+	protected:
+		static void _bind_methods();
 
 	public:
 
@@ -66,6 +74,22 @@ public:
 
 		spAtlas *atlas;
 		spSkeletonData *data;
+		// mix durations shared by every Spine node using this resource
+		spAnimationStateData *state_data;
+
+		// name -> index tables shared by every Spine node using this resource, built once the data is loaded
+		void build_name_index();
+		int find_bone(const StringName& p_name) const;
+		int find_slot(const StringName& p_name) const;
+		int find_animation(const StringName& p_name) const;
+
+		// members of each instance group, the first one is the leader whose pose the others draw
+		Map<StringName, Vector<Spine *> > instance_groups;
+
+		void set_default_mix(real_t p_duration);
+		real_t get_default_mix() const;
+		void set_mix(const StringName& p_from, const StringName& p_to, real_t p_duration);
+		real_t get_mix(const StringName& p_from, const StringName& p_to) const;
 	};
 
 private:
@@ -119,19 +143,72 @@ private:
 	typedef List<AttachmentNode> AttachmentNodes;
 	AttachmentNodes attachment_nodes;
 
+	// threaded update (see SpineServer)
+	friend class SpineServer;
+	typedef struct DeferredEvent {
+		int track;
+		spEventType type;
+		spEvent *event;
+		int loop_count;
+	} DeferredEvent;
+	bool threaded_update;
+	bool job_pending;
+	bool job_running;
+	float job_delta;
+	Vector<DeferredEvent> deferred_events;
+
+	// batched event dispatch (see set_batch_events)
+	bool batch_events;
+	Vector<DeferredEvent> event_batch;
+	int event_batch_count;
+	Vector<DeferredEvent> frame_events;
+	int frame_event_count;
+
+	// fixed timestep (see set_fixed_step)
+	float fixed_step;
+	bool fixed_step_interpolation;
+	double fixed_step_time;
+	bool fixed_step_pose_valid;
+	int max_steps_per_frame;
+	Vector<float> fixed_step_poses; // previous then current world transform of every bone, see _store_fixed_step_pose
+
+	// rollback snapshots (see save_state), the buffers are kept and reused
+	Vector<Vector<uint8_t> > states;
+
+	// instancing (see set_instance_group)
+	StringName instance_group;
+	Vector<Spine *> *instance_members;
+
 	static void spine_animation_callback(spAnimationState* p_state, spEventType p_type, spTrackEntry* p_track, spEvent* p_event);
 	void _on_animation_state_event(int p_track, spEventType p_type, spEvent *p_event, int p_loop_count);
+	bool _has_connections(const StringName &p_signal) const;
+	void _flush_event_batch();
 
 	void _spine_dispose();
-	void _animation_process(float p_delta);
+	void _animation_process(float p_delta, bool p_uncapped = false);
+	void _animation_update(float p_delta, int p_max_steps = 0);
+	void _animation_apply_state();
+	void _animation_step(float p_delta);
+	void _store_fixed_step_pose();
+	void _blend_fixed_step_pose(float p_alpha);
+	void _animation_apply_results();
+	void _animation_job();
+	void _animation_job_finish();
+	void _update_server_registration();
 	void _animation_draw();
 	void _set_process(bool p_process, bool p_force = false);
 	void _on_fx_draw();
 	void _update_verties_count();
+	spAnimationStateData *_get_local_state_data();
+	void _write_state(Vector<uint8_t> &r_buffer) const;
+	bool _read_state(const Vector<uint8_t> &p_buffer);
+	void _join_instance_group();
+	void _leave_instance_group();
+	_FORCE_INLINE_ bool _is_instance_follower() const { return instance_members != NULL && (*instance_members)[0] != this; }
+	// the skeleton whose pose is drawn: the group leader's when instanced
+	_FORCE_INLINE_ spSkeleton *_get_pose_skeleton() const { return instance_members != NULL ? (*instance_members)[0]->skeleton : skeleton; }
 
 protected:
-	static Array *invalid_names;
-
 	bool _set(const StringName& p_name, const Variant& p_value);
 	bool _get(const StringName& p_name, Variant &r_ret) const;
 	void _get_property_list(List<PropertyInfo> *p_list) const;
@@ -140,29 +217,40 @@ protected:
 	static void _bind_methods();
 
 public:
-	static Array get_invalid_names();
-
 	// set/get spine resource
 	void set_resource(Ref<SpineResource> p_data);
 	Ref<SpineResource> get_resource();
 
 	Array get_animation_names() const;
 
-	bool has_animation(const String& p_name);
+	bool has_animation(const StringName& p_name);
 	void set_default_mix(real_t p_duration);
 	void mix(const String& p_from, const String& p_to, real_t p_duration);
 
-	bool play(const String& p_name, bool p_loop = false, int p_track = 0, int p_delay = 0);
-	bool add(const String& p_name, bool p_loop = false, int p_track = 0, int p_delay = 0);
+	bool play(const StringName& p_name, bool p_loop = false, int p_track = 0, int p_delay = 0);
+	bool add(const StringName& p_name, bool p_loop = false, int p_track = 0, int p_delay = 0);
 	void clear(int p_track = -1);
 	void stop();
 	bool is_playing(int p_track = 0) const;
-	float get_animation_length(String p_animation) const;
+	float get_animation_length(const StringName& p_animation) const;
 	void set_forward(bool p_forward = true);
 	bool is_forward() const;
 	void set_skip_frames(int p_skip_frames);
 	int get_skip_frames() const;
 	String get_current_animation(int p_track);
+	// allocation free accessors for polling every frame
+	int get_current_animation_index(int p_track = 0) const;
+	float get_track_time(int p_track = 0) const;
+	float get_animation_time(int p_track = 0) const;
+	float get_mix_alpha(int p_track = 0) const;
+	int find_bone(const StringName& p_bone_name) const;
+	int find_slot(const StringName& p_slot_name) const;
+	Transform2D get_bone_transform(int p_bone) const;
+	// three Vector2 per requested bone: x axis, y axis and origin of its transform
+	PoolVector2Array get_bone_transforms(const PoolIntArray& p_bones) const;
+	// restrict a track to the listed bones and the slots attached to them
+	void set_track_mask(int p_track, const PoolStringArray& p_bones, bool p_include_children = true);
+	void clear_track_mask(int p_track);
 	void stop_all();
 	void reset();
 	void seek(float p_pos);
@@ -191,6 +279,41 @@ public:
 	void set_animation_process_mode(AnimationProcessMode p_mode);
 	AnimationProcessMode get_animation_process_mode() const;
 
+	// update the skeleton on SpineServer worker threads instead of the main thread
+	void set_threaded_update(bool p_enable);
+	bool is_threaded_update() const;
+
+	// collect start/complete/end/event notifications during a frame and emit them once as "animation_events"
+	void set_batch_events(bool p_enable);
+	bool is_batch_events() const;
+	// events batched during the last processed frame
+	Array get_frame_events() const;
+
+	// advance the animation state in exact ticks of p_step seconds so poses only depend on elapsed time, 0 to disable
+	void set_fixed_step(float p_step);
+	float get_fixed_step() const;
+	// blend between the last two ticks by the time left over, so rendering stays smooth at any frame rate
+	void set_fixed_step_interpolation(bool p_enable);
+	bool is_fixed_step_interpolation() const;
+	// ticks run in one frame at most, the others are delayed to the next frames rather than dropped so a hitch
+	// doesn't stall them, 0 for no limit. seek runs every tick it needs at once.
+	void set_max_steps_per_frame(int p_steps);
+	int get_max_steps_per_frame() const;
+
+	// snapshot the animation state and pose into slot p_slot, reusing the slot's buffer
+	void save_state(int p_slot = 0);
+	// restore a snapshot taken by save_state, returns false if the slot is empty
+	bool load_state(int p_slot = 0);
+	void clear_states();
+
+	// nodes with the same resource and group draw one shared pose: the first member (the leader) updates it,
+	// the others skip their own animation update and only keep their transform, modulate and flips. Groups are
+	// named rather than matched by animation and time, so playing on a member other than the leader has no
+	// visible effect until it leaves the group, it then continues from the shared pose
+	void set_instance_group(const StringName& p_group);
+	StringName get_instance_group() const;
+	bool is_instance_leader() const;
+
 	/* Sets the skin used to look up attachments not found in the SkeletonData defaultSkin. Attachments from the new skin are
 	* attached if the corresponding attachment from the old skin was attached. If there was no old skin, each slot's setup mode
 	* attachment is attached from the new skin. Returns false if the skin was not found.
@@ -202,15 +325,15 @@ public:
 	/* Returns null if the slot or attachment was not found. */
 	Dictionary get_attachment(const String& p_slot_name, const String& p_attachment_name) const;
 	/* Returns null if the bone was not found. */
-	Dictionary get_bone(const String& p_bone_name) const;
+	Dictionary get_bone(const StringName& p_bone_name) const;
 	/* Returns null if the slot was not found. */
-	Dictionary get_slot(const String& p_slot_name) const;
+	Dictionary get_slot(const StringName& p_slot_name) const;
 	/* Returns false if the slot or attachment was not found. */
-	bool set_attachment(const String& p_slot_name, const Variant& p_attachment);
+	bool set_attachment(const StringName& p_slot_name, const Variant& p_attachment);
 	// bind node to bone, auto update pos/rotate/scale
-	bool has_attachment_node(const String& p_bone_name, const Variant& p_node);
-	bool add_attachment_node(const String& p_bone_name, const Variant& p_node, const Vector2& p_ofs = Vector2(0, 0), const Vector2& p_scale = Vector2(1, 1), const real_t p_rot = 0);
-	bool remove_attachment_node(const String& p_bone_name, const Variant& p_node);
+	bool has_attachment_node(const StringName& p_bone_name, const Variant& p_node);
+	bool add_attachment_node(const StringName& p_bone_name, const Variant& p_node, const Vector2& p_ofs = Vector2(0, 0), const Vector2& p_scale = Vector2(1, 1), const real_t p_rot = 0);
+	bool remove_attachment_node(const StringName& p_bone_name, const Variant& p_node);
 	// get spine bounding box
 	Ref<Shape2D> get_bounding_box(const String& p_slot_name, const String& p_attachment_name);
 	// bind collision object 2d to spine bounding box
@@ -0,0 +1,264 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+#include "spine_cache.h"
+#include "core/math/md5.h"
+
+#include <spine/extension.h>
+#include <string.h>
+
+Mutex *SpineCache::lock = NULL;
+HashMap<String, SpineCache::Entry *> SpineCache::atlases;
+HashMap<String, SpineCache::Entry *> SpineCache::skeletons;
+Map<const void *, SpineCache::Entry *> SpineCache::entries;
+
+// the lock is gone once the module is unregistered, resources freed after that release their entries alone
+#define CACHE_LOCK \
+	if (lock)      \
+		lock->lock();
+
+#define CACHE_UNLOCK \
+	if (lock)        \
+		lock->unlock();
+
+static void _spine_dispose_atlas(void *p_atlas) {
+
+	spAtlas_dispose((spAtlas *)p_atlas);
+}
+
+static void _spine_dispose_skeleton_data(void *p_data) {
+
+	spSkeletonData_dispose((spSkeletonData *)p_data);
+}
+
+String SpineCache::content_key(const char *p_data, int p_length) {
+
+	MD5_CTX ctx;
+	MD5Init(&ctx);
+	MD5Update(&ctx, (unsigned char *)p_data, p_length);
+	MD5Final(&ctx);
+	return String::md5(ctx.digest);
+}
+
+SpineCache::Entry *SpineCache::_acquire(HashMap<String, Entry *> &p_map, const String &p_key) {
+
+	Entry **entry = p_map.getptr(p_key);
+	if (!entry)
+		return NULL;
+	(*entry)->references++;
+	return *entry;
+}
+
+SpineCache::Entry *SpineCache::_add(HashMap<String, Entry *> &p_map, const Vector<String> &p_keys, void *p_object, const String &p_path) {
+
+	// another load of the same content may have finished first, its entry then gets the missing keys
+	Entry *entry = NULL;
+	for (int i = 0; i < p_keys.size() && !entry; i++) {
+
+		Entry **found = p_map.getptr(p_keys[i]);
+		if (found)
+			entry = *found;
+	}
+
+	if (entry) {
+
+		entry->references++;
+	} else {
+
+		entry = memnew(Entry);
+		entry->object = p_object;
+		entry->atlas = &p_map == &atlases;
+		entry->path = p_path;
+		entry->references = 1;
+		entry->size = 0;
+		entry->texture_size = 0;
+		entries[p_object] = entry;
+	}
+
+	for (int i = 0; i < p_keys.size(); i++) {
+
+		if (!p_map.has(p_keys[i])) {
+
+			p_map[p_keys[i]] = entry;
+			entry->keys.push_back(p_keys[i]);
+		}
+	}
+	return entry;
+}
+
+bool SpineCache::_release(HashMap<String, Entry *> &p_map, const void *p_object, void (*p_dispose)(void *)) {
+
+	CACHE_LOCK
+	Map<const void *, Entry *>::Element *E = entries.find(p_object);
+	if (!E) {
+
+		CACHE_UNLOCK
+		return false;
+	}
+
+	Entry *entry = E->get();
+	if (--entry->references > 0) {
+
+		CACHE_UNLOCK
+		return true;
+	}
+
+	for (int i = 0; i < entry->keys.size(); i++)
+		p_map.erase(entry->keys[i]);
+	entries.erase(E);
+	CACHE_UNLOCK
+
+	p_dispose(entry->object);
+	memdelete(entry);
+	return true;
+}
+
+spAtlas *SpineCache::acquire_atlas(const String &p_key, Array *r_invalid_names) {
+
+	CACHE_LOCK
+	Entry *entry = _acquire(atlases, p_key);
+	if (entry)
+		*r_invalid_names = entry->invalid_names;
+	CACHE_UNLOCK
+	return entry ? (spAtlas *)entry->object : NULL;
+}
+
+spAtlas *SpineCache::add_atlas(const String &p_key, const String &p_path, spAtlas *p_atlas, const Array &p_invalid_names) {
+
+	Vector<String> keys;
+	keys.push_back(p_key);
+
+	CACHE_LOCK
+	Entry *entry = _add(atlases, keys, p_atlas, p_path);
+	if (entry->object == p_atlas) {
+
+		entry->invalid_names = p_invalid_names;
+		entry->size = sizeof(spAtlas);
+		for (spAtlasPage *page = p_atlas->pages; page; page = page->next) {
+
+			entry->size += sizeof(spAtlasPage) + strlen(page->name) + 1;
+			// what the texture takes once uploaded, as RGBA8
+			entry->texture_size += (size_t)page->width * page->height * 4;
+		}
+		for (spAtlasRegion *region = p_atlas->regions; region; region = region->next) {
+
+			entry->size += sizeof(spAtlasRegion) + strlen(region->name) + 1;
+			if (region->splits)
+				entry->size += sizeof(int) * 4;
+			if (region->pads)
+				entry->size += sizeof(int) * 4;
+		}
+	}
+	CACHE_UNLOCK
+
+	if (entry->object != p_atlas)
+		spAtlas_dispose(p_atlas);
+	return (spAtlas *)entry->object;
+}
+
+spSkeletonData *SpineCache::acquire_skeleton_data(const String &p_key) {
+
+	CACHE_LOCK
+	Entry *entry = _acquire(skeletons, p_key);
+	CACHE_UNLOCK
+	return entry ? (spSkeletonData *)entry->object : NULL;
+}
+
+spSkeletonData *SpineCache::add_skeleton_data(const String &p_atlas_key, const String &p_source_key, const String &p_path, spSkeletonData *p_data) {
+
+	// attachments point to the regions of the atlas, the data is only shared by resources using the same one
+	Vector<String> keys;
+	if (!p_source_key.empty())
+		keys.push_back(p_source_key);
+	if (p_data->hash && p_data->hash[0])
+		keys.push_back(p_atlas_key + "/" + String::utf8(p_data->hash));
+	if (keys.empty())
+		return p_data;
+
+	CACHE_LOCK
+	Entry *entry = _add(skeletons, keys, p_data, p_path);
+	if (entry->object == p_data) {
+
+		if (_spArena *arena = _spSkeletonData_getArena(p_data)) {
+
+			int blocks, allocations;
+			_spArena_getStats(arena, &blocks, &entry->size, &allocations);
+		}
+	}
+	CACHE_UNLOCK
+
+	if (entry->object != p_data)
+		spSkeletonData_dispose(p_data);
+	return (spSkeletonData *)entry->object;
+}
+
+bool SpineCache::release_atlas(spAtlas *p_atlas) {
+
+	return _release(atlases, p_atlas, _spine_dispose_atlas);
+}
+
+bool SpineCache::release_skeleton_data(spSkeletonData *p_data) {
+
+	return _release(skeletons, p_data, _spine_dispose_skeleton_data);
+}
+
+Array SpineCache::get_stats() {
+
+	Array stats;
+	CACHE_LOCK
+	for (Map<const void *, Entry *>::Element *E = entries.front(); E; E = E->next()) {
+
+		const Entry *entry = E->get();
+		Dictionary d;
+		d["type"] = entry->atlas ? "atlas" : "skeleton";
+		d["path"] = entry->path;
+		d["references"] = entry->references;
+		d["bytes"] = (int64_t)entry->size;
+		if (entry->atlas)
+			d["texture_bytes"] = (int64_t)entry->texture_size;
+		stats.push_back(d);
+	}
+	CACHE_UNLOCK
+	return stats;
+}
+
+void SpineCache::setup() {
+
+	lock = Mutex::create();
+}
+
+void SpineCache::cleanup() {
+
+	if (lock)
+		memdelete(lock);
+	lock = NULL;
+}
+
+#endif // MODULE_SPINE_ENABLED
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+
+#ifndef SPINE_CACHE_H
+#define SPINE_CACHE_H
+
+#include "core/array.h"
+#include "core/dictionary.h"
+#include "core/hash_map.h"
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+
+#include <spine/spine.h>
+
+// Atlases and skeleton data shared by every SpineResource loaded from the same content, so a skeleton
+// reached through several paths, or exported both as .json and .skel, is held once in memory. Atlases
+// are keyed by their directory (their pages are loaded from it) and the hash of their contents, skeleton
+// data by the key of their atlas and either the hash of their source or the hash Spine exports with the
+// skeleton. Entries are reference counted by the resources using them and freed with the last one.
+class SpineCache {
+
+	struct Entry {
+		void *object;
+		bool atlas;
+		String path;
+		Vector<String> keys;
+		int references;
+		size_t size;
+		size_t texture_size;
+		Array invalid_names; // of an atlas
+	};
+
+	static Mutex *lock;
+	static HashMap<String, Entry *> atlases;
+	static HashMap<String, Entry *> skeletons;
+	static Map<const void *, Entry *> entries;
+
+	static Entry *_acquire(HashMap<String, Entry *> &p_map, const String &p_key);
+	static Entry *_add(HashMap<String, Entry *> &p_map, const Vector<String> &p_keys, void *p_object, const String &p_path);
+	static bool _release(HashMap<String, Entry *> &p_map, const void *p_object, void (*p_dispose)(void *));
+
+public:
+	static String content_key(const char *p_data, int p_length);
+
+	// a new reference to the atlas cached under p_key, with the names patched when it was parsed, or NULL
+	static spAtlas *acquire_atlas(const String &p_key, Array *r_invalid_names);
+	// caches a loaded atlas with its textures and returns it, or returns the one another load cached first
+	// under the same key and disposes p_atlas
+	static spAtlas *add_atlas(const String &p_key, const String &p_path, spAtlas *p_atlas, const Array &p_invalid_names);
+
+	static spSkeletonData *acquire_skeleton_data(const String &p_key);
+	// same as add_atlas, p_source_key may be empty when the source wasn't hashed
+	static spSkeletonData *add_skeleton_data(const String &p_atlas_key, const String &p_source_key, const String &p_path, spSkeletonData *p_data);
+
+	// false when the object isn't cached, the caller then disposes it
+	static bool release_atlas(spAtlas *p_atlas);
+	static bool release_skeleton_data(spSkeletonData *p_data);
+
+	// one dictionary per entry: type ("atlas" or "skeleton"), path, references, bytes (and texture_bytes for atlases)
+	static Array get_stats();
+
+	static void setup();
+	static void cleanup();
+};
+
+#endif // SPINE_CACHE_H
+
+#endif // MODULE_SPINE_ENABLED
@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+#include "spine_server.h"
+#include "spine.h"
+#include "spine_cache.h"
+#include "spine_textures.h"
+#include "core/os/os.h"
+#include "core/safe_refcount.h"
+
+SpineServer *SpineServer::singleton = NULL;
+
+SpineServer *SpineServer::get_singleton() {
+
+	return singleton;
+}
+
+void SpineServer::_thread_func(void *p_ud) {
+
+	SpineServer *server = (SpineServer *)p_ud;
+	while (true) {
+
+		server->work_sem->wait();
+		if (server->exit_threads)
+			break;
+		server->_run_jobs();
+		server->done_sem->post();
+	}
+}
+
+void SpineServer::_run_jobs() {
+
+	while (true) {
+
+		uint32_t idx = atomic_increment(&job_index) - 1;
+		if (idx >= job_count)
+			break;
+		job_list[idx]->_animation_job();
+	}
+}
+
+void SpineServer::_start_threads() {
+
+	int count = thread_count;
+	if (count < 0)
+		count = OS::get_singleton()->get_processor_count() - 1;
+	if (count <= 0)
+		return;
+
+	work_sem = Semaphore::create();
+	done_sem = Semaphore::create();
+	exit_threads = false;
+	for (int i = 0; i < count; i++)
+		threads.push_back(Thread::create(_thread_func, this));
+}
+
+void SpineServer::_finish_threads() {
+
+	if (threads.empty())
+		return;
+
+	exit_threads = true;
+	for (int i = 0; i < threads.size(); i++)
+		work_sem->post();
+	for (int i = 0; i < threads.size(); i++) {
+
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	threads.clear();
+
+	memdelete(work_sem);
+	memdelete(done_sem);
+	work_sem = NULL;
+	done_sem = NULL;
+}
+
+void SpineServer::_flush() {
+
+	flush_queued = false;
+
+	jobs.clear();
+	job_ids.clear();
+	for (int i = 0; i < nodes.size(); i++) {
+
+		if (nodes[i]->job_pending) {
+
+			jobs.push_back(nodes[i]);
+			job_ids.push_back(nodes[i]->get_instance_id());
+		}
+	}
+	if (jobs.empty())
+		return;
+
+	job_list = jobs.ptrw();
+	job_count = jobs.size();
+	job_index = 0;
+
+	// a single skeleton is cheaper to update inline than to wake the pool
+	if (job_count > 1) {
+
+		if (threads.empty())
+			_start_threads();
+		for (int i = 0; i < threads.size(); i++)
+			work_sem->post();
+	}
+	_run_jobs();
+	if (job_count > 1) {
+
+		for (int i = 0; i < threads.size(); i++)
+			done_sem->wait();
+	}
+
+	job_list = NULL;
+	job_count = 0;
+	jobs.clear();
+
+	// results are applied in registration order, so signals fire deterministically. A node freed by an earlier
+	// handler is gone, one whose update was finished otherwise (see Spine::set_threaded_update) is no longer pending.
+	for (int i = 0; i < job_ids.size(); i++) {
+
+		Spine *node = Object::cast_to<Spine>(ObjectDB::get_instance(job_ids[i]));
+		if (node != NULL && node->job_pending)
+			node->_animation_job_finish();
+	}
+	job_ids.clear();
+}
+
+void SpineServer::add_node(Spine *p_node) {
+
+	ERR_FAIL_COND(nodes.find(p_node) != -1);
+	nodes.push_back(p_node);
+}
+
+void SpineServer::remove_node(Spine *p_node) {
+
+	int idx = nodes.find(p_node);
+	if (idx != -1)
+		nodes.remove(idx);
+}
+
+void SpineServer::queue_flush() {
+
+	if (flush_queued)
+		return;
+	flush_queued = true;
+	call_deferred("_flush");
+}
+
+void SpineServer::set_thread_count(int p_count) {
+
+	if (thread_count == p_count)
+		return;
+	_finish_threads();
+	thread_count = p_count;
+}
+
+int SpineServer::get_thread_count() const {
+
+	return thread_count;
+}
+
+int SpineServer::get_node_count() const {
+
+	return nodes.size();
+}
+
+Array SpineServer::get_cache_stats() const {
+
+	return SpineCache::get_stats();
+}
+
+void SpineServer::set_texture_budget(int p_megabytes) {
+
+	ERR_FAIL_COND(p_megabytes < 0);
+	SpineTextures::set_budget((size_t)p_megabytes * 1024 * 1024);
+}
+
+int SpineServer::get_texture_budget() const {
+
+	return SpineTextures::get_budget() / (1024 * 1024);
+}
+
+Dictionary SpineServer::get_texture_stats() const {
+
+	return SpineTextures::get_stats();
+}
+
+void SpineServer::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("_flush"), &SpineServer::_flush);
+	ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &SpineServer::set_thread_count);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &SpineServer::get_thread_count);
+	ClassDB::bind_method(D_METHOD("get_node_count"), &SpineServer::get_node_count);
+	ClassDB::bind_method(D_METHOD("get_cache_stats"), &SpineServer::get_cache_stats);
+	ClassDB::bind_method(D_METHOD("set_texture_budget", "megabytes"), &SpineServer::set_texture_budget);
+	ClassDB::bind_method(D_METHOD("get_texture_budget"), &SpineServer::get_texture_budget);
+	ClassDB::bind_method(D_METHOD("get_texture_stats"), &SpineServer::get_texture_stats);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "thread_count", PROPERTY_HINT_RANGE, "-1,64,1"), "set_thread_count", "get_thread_count");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "texture_budget", PROPERTY_HINT_RANGE, "0,4096,1"), "set_texture_budget", "get_texture_budget");
+}
+
+SpineServer::SpineServer() {
+
+	singleton = this;
+	job_list = NULL;
+	job_count = 0;
+	job_index = 0;
+	thread_count = -1; // one worker per extra core
+	work_sem = NULL;
+	done_sem = NULL;
+	exit_threads = false;
+	flush_queued = false;
+}
+
+SpineServer::~SpineServer() {
+
+	_finish_threads();
+	singleton = NULL;
+}
+
+#endif // MODULE_SPINE_ENABLED
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+
+#ifndef SPINE_SERVER_H
+#define SPINE_SERVER_H
+
+#include "core/array.h"
+#include "core/dictionary.h"
+#include "core/object.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+class Spine;
+
+// Runs spAnimationState_update/apply and spSkeleton_updateWorldTransform for
+// every Spine node that opted in (Spine::set_threaded_update) as parallel
+// jobs. Nodes only queue their delta while processing; the server flushes the
+// queue once per frame through a deferred call, then hands the results
+// (signals, attachment nodes, redraw) back to each node on the main thread in
+// registration order.
+class SpineServer : public Object {
+
+	GDCLASS(SpineServer, Object);
+
+	static SpineServer *singleton;
+
+	Vector<Spine *> nodes;
+	Vector<Spine *> jobs;
+	// signal handlers may free or unregister queued nodes, their results are handed back by id
+	Vector<ObjectID> job_ids;
+	Spine **job_list;
+	uint32_t job_count;
+	uint32_t job_index;
+
+	int thread_count;
+	Vector<Thread *> threads;
+	Semaphore *work_sem;
+	Semaphore *done_sem;
+	bool exit_threads;
+	bool flush_queued;
+
+	static void _thread_func(void *p_ud);
+	void _run_jobs();
+	void _start_threads();
+	void _finish_threads();
+	void _flush();
+
+protected:
+	static void _bind_methods();
+
+public:
+	static SpineServer *get_singleton();
+
+	void add_node(Spine *p_node);
+	void remove_node(Spine *p_node);
+	void queue_flush();
+
+	void set_thread_count(int p_count);
+	int get_thread_count() const;
+	int get_node_count() const;
+	// see SpineCache::get_stats
+	Array get_cache_stats() const;
+	// see SpineTextures, in MiB with 0 for no limit
+	void set_texture_budget(int p_megabytes);
+	int get_texture_budget() const;
+	Dictionary get_texture_stats() const;
+
+	SpineServer();
+	~SpineServer();
+};
+
+#endif // SPINE_SERVER_H
+
+#endif // MODULE_SPINE_ENABLED
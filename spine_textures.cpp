@@ -0,0 +1,261 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+#include "spine_textures.h"
+#include "core/engine.h"
+#include "core/io/resource_loader.h"
+#include "core/project_settings.h"
+
+Mutex *SpineTextures::lock = NULL;
+SpineTextures::Page *SpineTextures::first = NULL;
+SpineTextures::Page *SpineTextures::last = NULL;
+bool SpineTextures::lazy = true;
+size_t SpineTextures::budget = 0;
+size_t SpineTextures::resident_size = 0;
+int SpineTextures::resident_count = 0;
+int SpineTextures::page_count = 0;
+uint64_t SpineTextures::loads = 0;
+uint64_t SpineTextures::evictions = 0;
+
+#define TEXTURES_LOCK \
+	if (lock)         \
+		lock->lock();
+
+#define TEXTURES_UNLOCK \
+	if (lock)           \
+		lock->unlock();
+
+void SpineTextures::_unlink(Page *p_page) {
+
+	if (p_page->prev)
+		p_page->prev->next = p_page->next;
+	else
+		first = p_page->next;
+	if (p_page->next)
+		p_page->next->prev = p_page->prev;
+	else
+		last = p_page->prev;
+	p_page->prev = NULL;
+	p_page->next = NULL;
+	resident_size -= p_page->size;
+	resident_count--;
+}
+
+void SpineTextures::_load(spAtlasPage *p_page, bool p_evict) {
+
+	Page *page = static_cast<Page *>(p_page->rendererObject);
+	Ref<Texture> texture = ResourceLoader::load(page->path);
+	if (texture.is_null()) {
+
+		page->failed = true;
+		ERR_PRINTS("Unable to load spine page texture: " + page->path);
+		return;
+	}
+
+	// regions already have their uvs when the size came from the atlas
+	if (p_page->width == 0 || p_page->height == 0) {
+
+		p_page->width = texture->get_width();
+		p_page->height = texture->get_height();
+	}
+
+	uint64_t frame = Engine::get_singleton()->get_idle_frames();
+	TEXTURES_LOCK
+	page->texture = texture;
+	// what the texture takes once uploaded, as RGBA8
+	page->size = (size_t)texture->get_width() * texture->get_height() * 4;
+	page->last_used = frame;
+	page->next = first;
+	if (first)
+		first->prev = page;
+	else
+		last = page;
+	first = page;
+	resident_size += page->size;
+	resident_count++;
+	loads++;
+	if (p_evict)
+		_evict(frame);
+	TEXTURES_UNLOCK
+}
+
+void SpineTextures::_evict(uint64_t p_frame) {
+
+	// the batchers of the nodes keep the textures of their last draw, a page still referenced there is shown by a
+	// node that may not draw again for a while, and is kept
+	Page *page = last;
+	while (budget && resident_size > budget && page && page->last_used != p_frame) {
+
+		Page *prev = page->prev;
+		if (page->texture->reference_get_count() == 1) {
+
+			_unlink(page);
+			page->texture.unref();
+			evictions++;
+		}
+		page = prev;
+	}
+}
+
+bool SpineTextures::create(spAtlasPage *p_page, const String &p_path) {
+
+	Page *page = memnew(Page);
+	page->path = p_path;
+	page->failed = false;
+	page->size = 0;
+	page->last_used = 0;
+	page->prev = NULL;
+	page->next = NULL;
+	p_page->rendererObject = page;
+
+	TEXTURES_LOCK
+	page_count++;
+	TEXTURES_UNLOCK
+	return !lazy || p_page->width == 0 || p_page->height == 0;
+}
+
+void SpineTextures::dispose(spAtlasPage *p_page) {
+
+	Page *page = static_cast<Page *>(p_page->rendererObject);
+	if (!page)
+		return;
+
+	TEXTURES_LOCK
+	if (page->texture.is_valid())
+		_unlink(page);
+	page_count--;
+	TEXTURES_UNLOCK
+	memdelete(page);
+	p_page->rendererObject = NULL;
+}
+
+void SpineTextures::load(spAtlasPage *p_page) {
+
+	// loaders may run in other threads than the one releasing pages, they only go over the budget
+	_load(p_page, false);
+}
+
+Ref<Texture> SpineTextures::get(spAtlasPage *p_page) {
+
+	Page *page = static_cast<Page *>(p_page->rendererObject);
+	if (!page)
+		return Ref<Texture>();
+
+	if (page->texture.is_null()) {
+
+		if (!page->failed)
+			_load(p_page, true);
+		return page->texture;
+	}
+
+	uint64_t frame = Engine::get_singleton()->get_idle_frames();
+	if (page->last_used != frame) {
+
+		TEXTURES_LOCK
+		page->last_used = frame;
+		if (page != first) {
+
+			_unlink(page);
+			page->next = first;
+			first->prev = page;
+			first = page;
+			resident_size += page->size;
+			resident_count++;
+		}
+		TEXTURES_UNLOCK
+	}
+	return page->texture;
+}
+
+void SpineTextures::load_skin(const spSkin *p_skin) {
+
+	if (p_skin == NULL)
+		return;
+
+	for (const _Entry *entry = SUB_CAST(const _spSkin, p_skin)->entries; entry; entry = entry->next) {
+
+		spAtlasRegion *region;
+		switch (entry->attachment->type) {
+			case SP_ATTACHMENT_REGION:
+				region = (spAtlasRegion *)((spRegionAttachment *)entry->attachment)->rendererObject;
+				break;
+			case SP_ATTACHMENT_MESH:
+				region = (spAtlasRegion *)((spMeshAttachment *)entry->attachment)->rendererObject;
+				break;
+			default:
+				continue;
+		}
+		if (region)
+			get(region->page);
+	}
+}
+
+void SpineTextures::set_budget(size_t p_budget) {
+
+	TEXTURES_LOCK
+	budget = p_budget;
+	_evict(Engine::get_singleton()->get_idle_frames());
+	TEXTURES_UNLOCK
+}
+
+size_t SpineTextures::get_budget() {
+
+	return budget;
+}
+
+Dictionary SpineTextures::get_stats() {
+
+	Dictionary stats;
+	TEXTURES_LOCK
+	stats["pages"] = page_count;
+	stats["resident_pages"] = resident_count;
+	stats["resident_bytes"] = (int64_t)resident_size;
+	stats["budget_bytes"] = (int64_t)budget;
+	stats["loads"] = (int64_t)loads;
+	stats["evictions"] = (int64_t)evictions;
+	TEXTURES_UNLOCK
+	return stats;
+}
+
+void SpineTextures::setup() {
+
+	lock = Mutex::create();
+	lazy = GLOBAL_GET("spine/textures/lazy_load");
+	budget = (size_t)(int)GLOBAL_GET("spine/textures/budget_mb") * 1024 * 1024;
+}
+
+void SpineTextures::cleanup() {
+
+	if (lock)
+		memdelete(lock);
+	lock = NULL;
+}
+
+#endif // MODULE_SPINE_ENABLED
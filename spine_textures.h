@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifdef MODULE_SPINE_ENABLED
+
+#ifndef SPINE_TEXTURES_H
+#define SPINE_TEXTURES_H
+
+#include "core/dictionary.h"
+#include "core/os/mutex.h"
+#include "scene/resources/texture.h"
+
+#include <spine/spine.h>
+
+// Textures of the atlas pages, every page has a SpineTextures::Page as renderer object. Unless
+// spine/textures/lazy_load is off, a page whose size is given by its atlas is only loaded the first time
+// one of its regions is drawn or a skin using it is set. Once the loaded pages exceed the budget, the least
+// recently drawn ones are released, down to the pages drawn this frame. Pages that a node showed in its last
+// draw are never released, even if it stopped drawing.
+class SpineTextures {
+
+public:
+	struct Page {
+		String path;
+		Ref<Texture> texture;
+		bool failed; // not loaded again every frame
+		size_t size;
+		uint64_t last_used; // idle frame
+		// loaded pages, most recently used first
+		Page *prev;
+		Page *next;
+	};
+
+private:
+	static Mutex *lock;
+	static Page *first;
+	static Page *last;
+	static bool lazy;
+	static size_t budget;
+	static size_t resident_size;
+	static int resident_count;
+	static int page_count;
+	static uint64_t loads;
+	static uint64_t evictions;
+
+	static void _unlink(Page *p_page);
+	static void _load(spAtlasPage *p_page, bool p_evict);
+	static void _evict(uint64_t p_frame);
+
+public:
+	// gives the page its renderer object, returns true when the texture is needed right away
+	static bool create(spAtlasPage *p_page, const String &p_path);
+	static void dispose(spAtlasPage *p_page);
+	// for pages needed right away, from any thread
+	static void load(spAtlasPage *p_page);
+
+	// the texture of the page, loaded if it isn't, from the main thread
+	static Ref<Texture> get(spAtlasPage *p_page);
+	// loads the pages of every region and mesh attachment of the skin
+	static void load_skin(const spSkin *p_skin);
+
+	// in bytes, 0 for no limit
+	static void set_budget(size_t p_budget);
+	static size_t get_budget();
+	static Dictionary get_stats();
+
+	static void setup();
+	static void cleanup();
+};
+
+#endif // SPINE_TEXTURES_H
+
+#endif // MODULE_SPINE_ENABLED
@@ -1528,3 +1528,30 @@ void spPathConstraintMixTimeline_setFrame (spPathConstraintMixTimeline* self, in
 	self->frames[frameIndex + PATHCONSTRAINTMIX_ROTATE] = rotateMix;
 	self->frames[frameIndex + PATHCONSTRAINTMIX_TRANSLATE] = translateMix;
 }
+
+/**/
+
+/* Indexed by spTimelineType. */
+static const _spTimelineVtable _spTimelineVtables[] = {
+	{_spRotateTimeline_apply, _spRotateTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spTranslateTimeline_apply, _spTranslateTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spScaleTimeline_apply, _spScaleTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spShearTimeline_apply, _spShearTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spAttachmentTimeline_apply, _spAttachmentTimeline_getPropertyId, _spAttachmentTimeline_dispose},
+	{_spColorTimeline_apply, _spColorTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spDeformTimeline_apply, _spDeformTimeline_getPropertyId, _spDeformTimeline_dispose},
+	{_spEventTimeline_apply, _spEventTimeline_getPropertyId, _spEventTimeline_dispose},
+	{_spDrawOrderTimeline_apply, _spDrawOrderTimeline_getPropertyId, _spDrawOrderTimeline_dispose},
+	{_spIkConstraintTimeline_apply, _spIkConstraintTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spTransformConstraintTimeline_apply, _spTransformConstraintTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spPathConstraintPositionTimeline_apply, _spPathConstraintPositionTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spPathConstraintSpacingTimeline_apply, _spPathConstraintSpacingTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spPathConstraintMixTimeline_apply, _spPathConstraintMixTimeline_getPropertyId, _spBaseTimeline_dispose},
+	{_spTwoColorTimeline_apply, _spTwoColorTimeline_getPropertyId, _spBaseTimeline_dispose}
+};
+
+int _spTimeline_setSharedVtable (spTimeline* self) {
+	if ((unsigned int)self->type >= sizeof(_spTimelineVtables) / sizeof(_spTimelineVtables[0])) return 0;
+	CONST_CAST(const _spTimelineVtable*, self->vtable) = &_spTimelineVtables[self->type];
+	return 1;
+}
@@ -36,6 +36,7 @@
 #define FIRST 1
 #define DIP 2
 #define DIP_MIX 3
+#define MASKED -1
 
 _SP_ARRAY_IMPLEMENT_TYPE(spTrackEntryArray, spTrackEntry*)
 
@@ -45,9 +46,14 @@ void spAnimationState_disposeStatics () {
 	SP_EMPTY_ANIMATION = 0;
 }
 
+typedef struct _spTrackEntry {
+	spTrackEntry super;
+	int timelinesRotationCapacity;
+} _spTrackEntry;
+
 /* Forward declaration of some "private" functions so we can keep
    the same function order in C as we have method order in Java */
-void _spAnimationState_disposeTrackEntry (spTrackEntry* entry);
+void _spAnimationState_disposeTrackEntry (spAnimationState* self, spTrackEntry* entry);
 void _spAnimationState_disposeTrackEntries (spAnimationState* state, spTrackEntry* entry);
 int /*boolean*/ _spAnimationState_updateMixingFrom (spAnimationState* self, spTrackEntry* entry, float delta);
 float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* entry, spSkeleton* skeleton, spMixPose currentPose);
@@ -165,7 +171,7 @@ void _spEventQueue_drain (_spEventQueue* self) {
 			case SP_ANIMATION_DISPOSE:
 				if (entry->listener) entry->listener(SUPER(self->state), SP_ANIMATION_DISPOSE, entry, 0);
 				if (self->state->super.listener) self->state->super.listener(SUPER(self->state), SP_ANIMATION_DISPOSE, entry, 0);
-				_spAnimationState_disposeTrackEntry(entry);
+				_spAnimationState_disposeTrackEntry(SUPER(self->state), entry);
 				break;
 			case SP_ANIMATION_EVENT:
 				event = self->objects[i+2].event;
@@ -191,11 +197,45 @@ void _spAnimationState_disableQueue(spAnimationState* self) {
 	internal->queue->drainDisabled = 1;
 }
 
-void _spAnimationState_disposeTrackEntry (spTrackEntry* entry) {
+static void _spTrackEntry_free (spTrackEntry* entry) {
 	spIntArray_dispose(entry->timelineData);
 	spTrackEntryArray_dispose(entry->timelineDipMix);
 	FREE(entry->timelinesRotation);
-	FREE(entry);
+	FREE(SUB_CAST(_spTrackEntry, entry));
+}
+
+/* Returns the entry to the state's pool, keeping its timeline arrays for the next entry. */
+void _spAnimationState_disposeTrackEntry (spAnimationState* self, spTrackEntry* entry) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	entry->next = internal->trackEntryPool;
+	internal->trackEntryPool = entry;
+}
+
+static spTrackEntry* _spAnimationState_obtainTrackEntry (spAnimationState* self) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	spTrackEntry* entry = internal->trackEntryPool;
+	spIntArray* timelineData;
+	spTrackEntryArray* timelineDipMix;
+	float* timelinesRotation;
+
+	if (!entry) {
+		entry = SUPER(NEW(_spTrackEntry));
+		entry->timelineData = spIntArray_create(16);
+		entry->timelineDipMix = spTrackEntryArray_create(16);
+		return entry;
+	}
+	internal->trackEntryPool = entry->next;
+
+	timelineData = entry->timelineData;
+	timelineDipMix = entry->timelineDipMix;
+	timelinesRotation = entry->timelinesRotation;
+	memset(entry, 0, sizeof(spTrackEntry));
+	entry->timelineData = timelineData;
+	entry->timelineDipMix = timelineDipMix;
+	entry->timelinesRotation = timelinesRotation;
+	spIntArray_clear(timelineData);
+	spTrackEntryArray_clear(timelineDipMix);
+	return entry;
 }
 
 void _spAnimationState_disposeTrackEntries (spAnimationState* state, spTrackEntry* entry) {
@@ -206,12 +246,12 @@ void _spAnimationState_disposeTrackEntries (spAnimationState* state, spTrackEntr
 			spTrackEntry* nextFrom = from->mixingFrom;
 			if (entry->listener) entry->listener(state, SP_ANIMATION_DISPOSE, from, 0);
 			if (state->listener) state->listener(state, SP_ANIMATION_DISPOSE, from, 0);
-			_spAnimationState_disposeTrackEntry(from);
+			_spAnimationState_disposeTrackEntry(state, from);
 			from = nextFrom;
 		}
 		if (entry->listener) entry->listener(state, SP_ANIMATION_DISPOSE, entry, 0);
 		if (state->listener) state->listener(state, SP_ANIMATION_DISPOSE, entry, 0);
-		_spAnimationState_disposeTrackEntry(entry);
+		_spAnimationState_disposeTrackEntry(state, entry);
 		entry = next;
 	}
 }
@@ -235,6 +275,8 @@ spAnimationState* spAnimationState_create (spAnimationStateData* data) {
 	internal->events = CALLOC(spEvent*, 128);
 
 	internal->propertyIDs = CALLOC(int, 128);
+	internal->propertyIDsStamps = CALLOC(unsigned int, 128);
+	internal->propertyIDsStamp = 1;
 	internal->propertyIDsCapacity = 128;
 
 	self->mixingTo = spTrackEntryArray_create(16);
@@ -248,9 +290,18 @@ void spAnimationState_dispose (spAnimationState* self) {
 	for (i = 0; i < self->tracksCount; i++)
 		_spAnimationState_disposeTrackEntries(self, self->tracks[i]);
 	FREE(self->tracks);
+	while (internal->trackEntryPool) {
+		spTrackEntry* next = internal->trackEntryPool->next;
+		_spTrackEntry_free(internal->trackEntryPool);
+		internal->trackEntryPool = next;
+	}
+	for (i = 0; i < internal->trackMasksCount; i++)
+		FREE(internal->trackMasks[i]);
+	FREE(internal->trackMasks);
 	_spEventQueue_free(internal->queue);
 	FREE(internal->events);
 	FREE(internal->propertyIDs);
+	FREE(internal->propertyIDsStamps);
 	spTrackEntryArray_dispose(self->mixingTo);
     FREE(internal);
 }
@@ -344,6 +395,24 @@ int /*boolean*/ _spAnimationState_updateMixingFrom (spAnimationState* self, spTr
 	return 0;
 }
 
+/* Returns true if applying the timeline with zero alpha over the current pose leaves the skeleton unchanged. Rotate, scale, IK,
+ * deform, attachment, draw order and event timelines have effects even at zero alpha, so they are always applied. */
+static int /*boolean*/ _spAnimationState_isNoOpAtZeroAlpha (const spTimeline* timeline) {
+	switch (timeline->type) {
+		case SP_TIMELINE_TRANSLATE:
+		case SP_TIMELINE_SHEAR:
+		case SP_TIMELINE_COLOR:
+		case SP_TIMELINE_TWOCOLOR:
+		case SP_TIMELINE_TRANSFORMCONSTRAINT:
+		case SP_TIMELINE_PATHCONSTRAINTPOSITION:
+		case SP_TIMELINE_PATHCONSTRAINTSPACING:
+		case SP_TIMELINE_PATHCONSTRAINTMIX:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
 int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	spTrackEntry* current;
@@ -379,8 +448,11 @@ int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 		timelineCount = current->animation->timelinesCount;
 		timelines = current->animation->timelines;
 		if (mix == 1) {
-			for (ii = 0; ii < timelineCount; ii++)
+			int* timelineData = current->timelineData->items;
+			for (ii = 0; ii < timelineCount; ii++) {
+				if (timelineData[ii] == MASKED) continue;
 				spTimeline_apply(timelines[ii], skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+			}
 		} else {
 			spIntArray* timelineData = current->timelineData;
 
@@ -389,8 +461,10 @@ int spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 			timelinesRotation = current->timelinesRotation;
 
 			for (ii = 0; ii < timelineCount; ii++) {
+				if (timelineData->items[ii] == MASKED) continue;
 				timeline = timelines[ii];
 				pose = timelineData->items[ii] >= FIRST ? SP_MIX_POSE_SETUP : currentPose;
+				if (mix == 0 && pose != SP_MIX_POSE_SETUP && _spAnimationState_isNoOpAtZeroAlpha(timeline)) continue;
 				if (timeline->type == SP_TIMELINE_ROTATE)
 					_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, mix, pose, timelinesRotation, ii << 1, firstFrame);
 				else
@@ -472,6 +546,8 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 				pose = SP_MIX_POSE_SETUP;
 				alpha = alphaDip;
 				break;
+			case MASKED:
+				continue;
 			default:
 				pose = SP_MIX_POSE_SETUP;
 				alpha = alphaDip;
@@ -480,6 +556,7 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 				break;
 		}
 		from->totalAlpha += alpha;
+		if (alpha == 0 && pose != SP_MIX_POSE_SETUP && _spAnimationState_isNoOpAtZeroAlpha(timeline)) continue;
 		if (timeline->type == SP_TIMELINE_ROTATE)
 			_spAnimationState_applyRotateTimeline(self, timeline, skeleton, animationTime, alpha, pose, timelinesRotation, i << 1, firstFrame);
 		else {
@@ -493,6 +570,13 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* t
 	from->nextAnimationLast = animationTime;
 	from->nextTrackLast = from->trackTime;
 
+	/* This was the last application of a finished mix, end it now instead of on the next update so it is not applied again. */
+	if (mix == 1 && (from->totalAlpha == 0 || to->mixDuration == 0)) {
+		to->mixingFrom = from->mixingFrom;
+		to->interruptAlpha = from->interruptAlpha;
+		_spEventQueue_end(internal->queue, from);
+	}
+
 	return mix;
 }
 
@@ -780,7 +864,7 @@ spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index
 }
 
 spTrackEntry* _spAnimationState_trackEntry (spAnimationState* self, int trackIndex, spAnimation* animation, int /*boolean*/ loop, spTrackEntry* last) {
-	spTrackEntry* entry = NEW(spTrackEntry);
+	spTrackEntry* entry = _spAnimationState_obtainTrackEntry(self);
 	entry->trackIndex = trackIndex;
 	entry->animation = animation;
 	entry->loop = loop;
@@ -805,9 +889,6 @@ spTrackEntry* _spAnimationState_trackEntry (spAnimationState* self, int trackInd
 	entry->interruptAlpha = 1;
 	entry->mixTime = 0;
 	entry->mixDuration = !last ? 0 : spAnimationStateData_getMix(self->data, last->animation, animation);
-
-	entry->timelineData = spIntArray_create(16);
-	entry->timelineDipMix = spTrackEntryArray_create(16);
 	return entry;
 }
 
@@ -829,6 +910,10 @@ void _spAnimationState_animationsChanged (spAnimationState* self) {
 	internal->animationsChanged = 0;
 
 	internal->propertyIDsCount = 0;
+	if (++internal->propertyIDsStamp == 0) {
+		memset(internal->propertyIDsStamps, 0, sizeof(unsigned int) * internal->propertyIDsCapacity);
+		internal->propertyIDsStamp = 1;
+	}
 	i = 0; n = self->tracksCount;
 
 	mixingTo = self->mixingTo;
@@ -841,35 +926,69 @@ void _spAnimationState_animationsChanged (spAnimationState* self) {
 
 float* _spAnimationState_resizeTimelinesRotation(spTrackEntry* entry, int newSize) {
 	if (entry->timelinesRotationCount != newSize) {
-		float* newTimelinesRotation = CALLOC(float, newSize);
-		FREE(entry->timelinesRotation);
-		entry->timelinesRotation = newTimelinesRotation;
+		_spTrackEntry* internal = SUB_CAST(_spTrackEntry, entry);
+		if (internal->timelinesRotationCapacity < newSize) {
+			FREE(entry->timelinesRotation);
+			entry->timelinesRotation = CALLOC(float, newSize);
+			internal->timelinesRotationCapacity = newSize;
+		} else
+			memset(entry->timelinesRotation, 0, sizeof(float) * newSize);
 		entry->timelinesRotationCount = newSize;
 	}
 	return entry->timelinesRotation;
 }
 
+static int _spAnimationState_propertyIDBucket(const _spAnimationState* internal, int id) {
+	unsigned int hash = (unsigned int)id;
+	int mask = internal->propertyIDsCapacity - 1;
+	int bucket;
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bu;
+	hash ^= hash >> 16;
+	bucket = (int)(hash & mask);
+	while (internal->propertyIDsStamps[bucket] == internal->propertyIDsStamp && internal->propertyIDs[bucket] != id)
+		bucket = (bucket + 1) & mask;
+	return bucket;
+}
+
 void _spAnimationState_ensureCapacityPropertyIDs(spAnimationState* self, int capacity) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
-	if (internal->propertyIDsCapacity < capacity) {
-		int *newPropertyIDs = CALLOC(int, capacity << 1);
-		memcpy(newPropertyIDs, internal->propertyIDs, sizeof(int) * internal->propertyIDsCount);
-		FREE(internal->propertyIDs);
-		internal->propertyIDs = newPropertyIDs;
-		internal->propertyIDsCapacity = capacity << 1;
+	/* Keep the set at most half full. */
+	if (internal->propertyIDsCapacity < capacity << 1) {
+		int i;
+		int* oldPropertyIDs = internal->propertyIDs;
+		unsigned int* oldStamps = internal->propertyIDsStamps;
+		int oldCapacity = internal->propertyIDsCapacity;
+		unsigned int oldStamp = internal->propertyIDsStamp;
+		int newCapacity = oldCapacity;
+		while (newCapacity < capacity << 1)
+			newCapacity <<= 1;
+		internal->propertyIDs = CALLOC(int, newCapacity);
+		internal->propertyIDsStamps = CALLOC(unsigned int, newCapacity);
+		internal->propertyIDsCapacity = newCapacity;
+		internal->propertyIDsStamp = 1;
+		for (i = 0; i < oldCapacity; i++) {
+			if (oldStamps[i] == oldStamp) {
+				int bucket = _spAnimationState_propertyIDBucket(internal, oldPropertyIDs[i]);
+				internal->propertyIDs[bucket] = oldPropertyIDs[i];
+				internal->propertyIDsStamps[bucket] = 1;
+			}
+		}
+		FREE(oldPropertyIDs);
+		FREE(oldStamps);
 	}
 }
 
 int _spAnimationState_addPropertyID(spAnimationState* self, int id) {
-	int i, n;
+	int bucket;
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 
-	for (i = 0, n = internal->propertyIDsCount; i < n; i++) {
-		if (internal->propertyIDs[i] == id) return 0;
-	}
-
 	_spAnimationState_ensureCapacityPropertyIDs(self, internal->propertyIDsCount + 1);
-	internal->propertyIDs[internal->propertyIDsCount] = id;
+	bucket = _spAnimationState_propertyIDBucket(internal, id);
+	if (internal->propertyIDsStamps[bucket] == internal->propertyIDsStamp) return 0;
+
+	internal->propertyIDs[bucket] = id;
+	internal->propertyIDsStamps[bucket] = internal->propertyIDsStamp;
 	internal->propertyIDsCount++;
 	return 1;
 }
@@ -884,6 +1003,116 @@ void spAnimationState_clearListenerNotifications(spAnimationState* self) {
 	_spEventQueue_clear(internal->queue);
 }
 
+#define ANIMATION_STATE_VERSION 1
+
+static void _spAnimationState_writeEntry (spTrackEntry* entry, _spStateBuffer* buffer) {
+	/* The links are written as they are, a non-null mixingFrom or next means that entry follows. */
+	_spStateBuffer_write(buffer, entry, sizeof(spTrackEntry));
+	_spStateBuffer_write(buffer, entry->timelinesRotation, sizeof(float) * entry->timelinesRotationCount);
+	if (entry->mixingFrom) _spAnimationState_writeEntry(entry->mixingFrom, buffer);
+	if (entry->next) _spAnimationState_writeEntry(entry->next, buffer);
+}
+
+/* Reads an entry and the entries linked from it. When build is 0 the snapshot is only checked and 0 is returned. */
+static spTrackEntry* _spAnimationState_readEntry (spAnimationState* self, _spStateBuffer* buffer, int/*bool*/ build) {
+	spTrackEntry saved;
+	spTrackEntry* entry = 0;
+	if (!_spStateBuffer_read(buffer, &saved, sizeof(spTrackEntry))) return 0;
+	if (saved.timelinesRotationCount < 0 || buffer->size + (int)sizeof(float) * saved.timelinesRotationCount > buffer->capacity) {
+		buffer->error = 1;
+		return 0;
+	}
+
+	if (!build)
+		buffer->size += sizeof(float) * saved.timelinesRotationCount;
+	else {
+		_spTrackEntry* internal;
+		entry = _spAnimationState_obtainTrackEntry(self);
+		internal = SUB_CAST(_spTrackEntry, entry);
+		saved.timelineData = entry->timelineData;
+		saved.timelineDipMix = entry->timelineDipMix;
+		if (internal->timelinesRotationCapacity < saved.timelinesRotationCount) {
+			FREE(entry->timelinesRotation);
+			entry->timelinesRotation = MALLOC(float, saved.timelinesRotationCount);
+			internal->timelinesRotationCapacity = saved.timelinesRotationCount;
+		}
+		saved.timelinesRotation = entry->timelinesRotation;
+		*entry = saved;
+		_spStateBuffer_read(buffer, entry->timelinesRotation, sizeof(float) * entry->timelinesRotationCount);
+	}
+
+	if (saved.mixingFrom) {
+		spTrackEntry* from = _spAnimationState_readEntry(self, buffer, build);
+		if (entry) entry->mixingFrom = from;
+	}
+	if (saved.next) {
+		spTrackEntry* next = _spAnimationState_readEntry(self, buffer, build);
+		if (entry) entry->next = next;
+	}
+	return entry;
+}
+
+static void _spAnimationState_releaseEntries (spAnimationState* self, spTrackEntry* entry) {
+	while (entry) {
+		spTrackEntry* next = entry->next;
+		if (entry->mixingFrom) _spAnimationState_releaseEntries(self, entry->mixingFrom);
+		_spAnimationState_disposeTrackEntry(self, entry);
+		entry = next;
+	}
+}
+
+int spAnimationState_saveState (spAnimationState* self, void* buffer, int capacity) {
+	int i;
+	_spStateBuffer state;
+	_spStateBuffer_init(&state, buffer, capacity);
+	_spStateBuffer_writeInt(&state, ANIMATION_STATE_VERSION);
+	_spStateBuffer_write(&state, &self->timeScale, sizeof(float));
+	_spStateBuffer_writeInt(&state, self->tracksCount);
+	for (i = 0; i < self->tracksCount; i++) {
+		_spStateBuffer_writeInt(&state, self->tracks[i] != 0);
+		if (self->tracks[i]) _spAnimationState_writeEntry(self->tracks[i], &state);
+	}
+	return state.size;
+}
+
+int spAnimationState_loadState (spAnimationState* self, const void* buffer, int size) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	_spStateBuffer state;
+	int i, tracksCount, pass;
+	float timeScale;
+
+	/* The first pass only checks the snapshot, so a bad one leaves the state untouched. */
+	for (pass = 0; pass < 2; pass++) {
+		_spStateBuffer_init(&state, buffer, size);
+		_spStateBuffer_expectInt(&state, ANIMATION_STATE_VERSION);
+		_spStateBuffer_read(&state, &timeScale, sizeof(float));
+		tracksCount = _spStateBuffer_readInt(&state);
+		if (state.error || tracksCount < 0) return 0;
+
+		if (pass) {
+			self->timeScale = timeScale;
+			for (i = 0; i < self->tracksCount; i++) {
+				_spAnimationState_releaseEntries(self, self->tracks[i]);
+				self->tracks[i] = 0;
+			}
+			if (tracksCount > 0) _spAnimationState_expandToIndex(self, tracksCount - 1);
+		}
+		for (i = 0; i < tracksCount; i++) {
+			if (_spStateBuffer_readInt(&state)) {
+				spTrackEntry* entry = _spAnimationState_readEntry(self, &state, pass);
+				if (pass) self->tracks[i] = entry;
+			}
+			if (state.error) return 0;
+		}
+	}
+
+	_spEventQueue_clear(internal->queue);
+	internal->animationsChanged = 1;
+	return state.size;
+}
+
+#undef ANIMATION_STATE_VERSION
+
 float spTrackEntry_getAnimationTime (spTrackEntry* entry) {
 	if (entry->loop) {
 		float duration = entry->animationEnd - entry->animationStart;
@@ -893,6 +1122,59 @@ float spTrackEntry_getAnimationTime (spTrackEntry* entry) {
 	return MIN(entry->trackTime + entry->animationStart, entry->animationEnd);
 }
 
+void spAnimationState_setTrackMask (spAnimationState* self, int trackIndex, const unsigned char* boneMask, const unsigned char* slotMask) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	spSkeletonData* skeletonData = self->data->skeletonData;
+	unsigned char* mask;
+
+	if (trackIndex >= internal->trackMasksCount) {
+		unsigned char** newTrackMasks;
+		if (!boneMask && !slotMask) return;
+		newTrackMasks = CALLOC(unsigned char*, trackIndex + 1);
+		if (internal->trackMasksCount > 0)
+			memcpy(newTrackMasks, internal->trackMasks, internal->trackMasksCount * sizeof(unsigned char*));
+		FREE(internal->trackMasks);
+		internal->trackMasks = newTrackMasks;
+		internal->trackMasksCount = trackIndex + 1;
+	}
+
+	FREE(internal->trackMasks[trackIndex]);
+	internal->trackMasks[trackIndex] = 0;
+	internal->animationsChanged = 1;
+	if (!boneMask && !slotMask) return;
+
+	mask = MALLOC(unsigned char, skeletonData->bonesCount + skeletonData->slotsCount);
+	if (boneMask)
+		memcpy(mask, boneMask, skeletonData->bonesCount);
+	else
+		memset(mask, 1, skeletonData->bonesCount);
+	if (slotMask)
+		memcpy(mask + skeletonData->bonesCount, slotMask, skeletonData->slotsCount);
+	else
+		memset(mask + skeletonData->bonesCount, 1, skeletonData->slotsCount);
+	internal->trackMasks[trackIndex] = mask;
+}
+
+static int /*boolean*/ _spAnimationState_isMasked (const unsigned char* mask, int bonesCount, const spTimeline* timeline) {
+	switch (timeline->type) {
+		case SP_TIMELINE_ROTATE:
+		case SP_TIMELINE_TRANSLATE:
+		case SP_TIMELINE_SCALE:
+		case SP_TIMELINE_SHEAR:
+			return !mask[((const spBaseTimeline*)timeline)->boneIndex];
+		case SP_TIMELINE_ATTACHMENT:
+			return !mask[bonesCount + ((const spAttachmentTimeline*)timeline)->slotIndex];
+		case SP_TIMELINE_COLOR:
+			return !mask[bonesCount + ((const spColorTimeline*)timeline)->slotIndex];
+		case SP_TIMELINE_TWOCOLOR:
+			return !mask[bonesCount + ((const spTwoColorTimeline*)timeline)->slotIndex];
+		case SP_TIMELINE_DEFORM:
+			return !mask[bonesCount + ((const spDeformTimeline*)timeline)->slotIndex];
+		default:
+			return 0;
+	}
+}
+
 int /*boolean*/ _spTrackEntry_hasTimeline(spTrackEntry* self, int id) {
 	spTimeline** timelines = self->animation->timelines;
 	int i, n;
@@ -909,6 +1191,9 @@ spTrackEntry* _spTrackEntry_setTimelineData(spTrackEntry* self, spTrackEntry* to
 	int timelinesCount;
 	int* timelineData;
 	spTrackEntry** timelineDipMix;
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, state);
+	const unsigned char* mask = self->trackIndex < internal->trackMasksCount ? internal->trackMasks[self->trackIndex] : 0;
+	int bonesCount = state->data->skeletonData->bonesCount;
 	int i, ii;
 
 	if (to != 0) spTrackEntryArray_add(mixingToArray, to);
@@ -926,7 +1211,13 @@ spTrackEntry* _spTrackEntry_setTimelineData(spTrackEntry* self, spTrackEntry* to
 	i = 0;
 	continue_outer:
 	for (; i < timelinesCount; i++) {
-		int id = spTimeline_getPropertyId(timelines[i]);
+		int id;
+		if (mask && _spAnimationState_isMasked(mask, bonesCount, timelines[i])) {
+			/* Masked timelines do not claim their property, tracks below still key it. */
+			timelineData[i] = MASKED;
+			continue;
+		}
+		id = spTimeline_getPropertyId(timelines[i]);
 		if (!_spAnimationState_addPropertyID(state, id))
 			timelineData[i] = SUBSEQUENT;
 		else if (to == 0 || !_spTrackEntry_hasTimeline(to, id))
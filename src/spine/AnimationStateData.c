@@ -31,69 +31,75 @@
 #include <spine/AnimationStateData.h>
 #include <spine/extension.h>
 
-typedef struct _ToEntry _ToEntry;
-struct _ToEntry {
-	spAnimation* animation;
+typedef struct _spMixEntry {
+	spAnimation* from;
+	spAnimation* to;
 	float duration;
-	_ToEntry* next;
-};
-
-_ToEntry* _ToEntry_create (spAnimation* to, float duration) {
-	_ToEntry* self = NEW(_ToEntry);
-	self->animation = to;
-	self->duration = duration;
-	return self;
+} _spMixEntry;
+
+/* Mix durations are kept in an open addressing hash table keyed by the (from, to) pair, at most half full. */
+typedef struct _spAnimationStateData {
+	spAnimationStateData super;
+	_spMixEntry* mixes;
+	int mixesCount;
+	int mixesCapacity;
+	spAnimationStateData* parent;
+} _spAnimationStateData;
+
+static int _spAnimationStateData_findBucket (const _spAnimationStateData* self, const spAnimation* from, const spAnimation* to) {
+	unsigned int hash = (unsigned int)((size_t)from >> 3) * 31 + (unsigned int)((size_t)to >> 3);
+	int mask = self->mixesCapacity - 1;
+	int bucket;
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bu;
+	hash ^= hash >> 16;
+	bucket = (int)(hash & mask);
+	while (self->mixes[bucket].from && (self->mixes[bucket].from != from || self->mixes[bucket].to != to))
+		bucket = (bucket + 1) & mask;
+	return bucket;
 }
 
-void _ToEntry_dispose (_ToEntry* self) {
-	FREE(self);
+static void _spAnimationStateData_ensureCapacity (_spAnimationStateData* self, int count) {
+	int i;
+	_spMixEntry* oldMixes = self->mixes;
+	int oldCapacity = self->mixesCapacity;
+	if (self->mixesCapacity >= count << 1) return;
+	if (!self->mixesCapacity) self->mixesCapacity = 16;
+	while (self->mixesCapacity < count << 1)
+		self->mixesCapacity <<= 1;
+	self->mixes = CALLOC(_spMixEntry, self->mixesCapacity);
+	for (i = 0; i < oldCapacity; ++i)
+		if (oldMixes[i].from) self->mixes[_spAnimationStateData_findBucket(self, oldMixes[i].from, oldMixes[i].to)] = oldMixes[i];
+	FREE(oldMixes);
 }
 
-/**/
-
-typedef struct _FromEntry _FromEntry;
-struct _FromEntry {
-	spAnimation* animation;
-	_ToEntry* toEntries;
-	_FromEntry* next;
-};
-
-_FromEntry* _FromEntry_create (spAnimation* from) {
-	_FromEntry* self = NEW(_FromEntry);
-	self->animation = from;
-	return self;
-}
-
-void _FromEntry_dispose (_FromEntry* self) {
-	FREE(self);
+static int /*bool*/ _spAnimationStateData_findMix (const spAnimationStateData* self, const spAnimation* from, const spAnimation* to, float* duration) {
+	const _spAnimationStateData* internal = SUB_CAST(_spAnimationStateData, self);
+	if (internal->mixesCount) {
+		const _spMixEntry* entry = internal->mixes + _spAnimationStateData_findBucket(internal, from, to);
+		if (entry->from) {
+			*duration = entry->duration;
+			return 1;
+		}
+	}
+	return internal->parent ? _spAnimationStateData_findMix(internal->parent, from, to, duration) : 0;
 }
 
-/**/
-
 spAnimationStateData* spAnimationStateData_create (spSkeletonData* skeletonData) {
-	spAnimationStateData* self = NEW(spAnimationStateData);
+	spAnimationStateData* self = SUPER(NEW(_spAnimationStateData));
 	CONST_CAST(spSkeletonData*, self->skeletonData) = skeletonData;
 	return self;
 }
 
-void spAnimationStateData_dispose (spAnimationStateData* self) {
-	_ToEntry* toEntry;
-	_ToEntry* nextToEntry;
-	_FromEntry* nextFromEntry;
-
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		toEntry = fromEntry->toEntries;
-		while (toEntry) {
-			nextToEntry = toEntry->next;
-			_ToEntry_dispose(toEntry);
-			toEntry = nextToEntry;
-		}
-		nextFromEntry = fromEntry->next;
-		_FromEntry_dispose(fromEntry);
-		fromEntry = nextFromEntry;
-	}
+spAnimationStateData* spAnimationStateData_createOverlay (spAnimationStateData* parent) {
+	spAnimationStateData* self = spAnimationStateData_create(parent->skeletonData);
+	self->defaultMix = parent->defaultMix;
+	SUB_CAST(_spAnimationStateData, self)->parent = parent;
+	return self;
+}
 
+void spAnimationStateData_dispose (spAnimationStateData* self) {
+	FREE(SUB_CAST(_spAnimationStateData, self)->mixes);
 	FREE(self);
 }
 
@@ -107,45 +113,20 @@ void spAnimationStateData_setMixByName (spAnimationStateData* self, const char*
 }
 
 void spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration) {
-	/* Find existing FromEntry. */
-	_ToEntry* toEntry;
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			/* Find existing ToEntry. */
-			toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) {
-					toEntry->duration = duration;
-					return;
-				}
-				toEntry = toEntry->next;
-			}
-			break; /* Add new ToEntry to the existing FromEntry. */
-		}
-		fromEntry = fromEntry->next;
-	}
-	if (!fromEntry) {
-		fromEntry = _FromEntry_create(from);
-		fromEntry->next = (_FromEntry*)self->entries;
-		CONST_CAST(_FromEntry*, self->entries) = fromEntry;
+	_spAnimationStateData* internal = SUB_CAST(_spAnimationStateData, self);
+	_spMixEntry* entry;
+	_spAnimationStateData_ensureCapacity(internal, internal->mixesCount + 1);
+	entry = internal->mixes + _spAnimationStateData_findBucket(internal, from, to);
+	if (!entry->from) {
+		entry->from = from;
+		entry->to = to;
+		internal->mixesCount++;
 	}
-	toEntry = _ToEntry_create(to, duration);
-	toEntry->next = fromEntry->toEntries;
-	fromEntry->toEntries = toEntry;
+	entry->duration = duration;
 }
 
 float spAnimationStateData_getMix (spAnimationStateData* self, spAnimation* from, spAnimation* to) {
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			_ToEntry* toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) return toEntry->duration;
-				toEntry = toEntry->next;
-			}
-		}
-		fromEntry = fromEntry->next;
-	}
+	float duration;
+	if (_spAnimationStateData_findMix(self, from, to, &duration)) return duration;
 	return self->defaultMix;
 }
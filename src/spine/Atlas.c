@@ -32,6 +32,15 @@
 #include <ctype.h>
 #include <spine/extension.h>
 
+typedef struct _spAtlas {
+	spAtlas super;
+	spAtlasRegion* regions; /* Contiguous, super.regions links them in the same order as the names in regionNames. */
+	int regionsCount;
+	int regionsCapacity;
+	_spArena* strings; /* The names, splits and pads of the regions. */
+	_spNameTable regionNames;
+} _spAtlas;
+
 spAtlasPage* spAtlasPage_create(spAtlas* atlas, const char* name) {
 	spAtlasPage* self = NEW(spAtlasPage);
 	CONST_CAST(spAtlas*, self->atlas) = atlas;
@@ -106,7 +115,7 @@ static int beginPast(Str* str, char c) {
 
 /* Returns 0 on failure. */
 static int readValue(const char** begin, const char* end, Str* str) {
-	readLine(begin, end, str);
+	if (!readLine(begin, end, str)) return 0;
 	if (!beginPast(str, ':')) return 0;
 	trim(str);
 	return 1;
@@ -116,7 +125,7 @@ static int readValue(const char** begin, const char* end, Str* str) {
 static int readTuple(const char** begin, const char* end, Str tuple[]) {
 	int i;
 	Str str = { NULL, NULL };
-	readLine(begin, end, &str);
+	if (!readLine(begin, end, &str)) return 0;
 	if (!beginPast(&str, ':')) return 0;
 
 	for (i = 0; i < 3; ++i) {
@@ -155,17 +164,54 @@ static int toInt(Str* str) {
 	return (int)strtol(str->begin, (char**)&str->end, 10);
 }
 
-static spAtlas* abortAtlas(spAtlas* self) {
-	spAtlas_dispose(self);
-	return 0;
+static char* arenaString(_spAtlas* self, Str* str) {
+	_spArena* previous = _spSetArena(self->strings);
+	char* string = mallocString(str);
+	_spSetArena(previous);
+	return string;
+}
+
+static int* arenaInts(_spAtlas* self, Str tuple[]) {
+	_spArena* previous = _spSetArena(self->strings);
+	int* values = MALLOC(int, 4);
+	_spSetArena(previous);
+	values[0] = toInt(tuple);
+	values[1] = toInt(tuple + 1);
+	values[2] = toInt(tuple + 2);
+	values[3] = toInt(tuple + 3);
+	return values;
+}
+
+/* Regions are appended to one array, so they can only be linked once all are read. */
+static spAtlasRegion* _spAtlas_addRegion(_spAtlas* self) {
+	spAtlasRegion* region;
+	if (self->regionsCount == self->regionsCapacity) {
+		self->regionsCapacity <<= 1;
+		self->regions = REALLOC(self->regions, spAtlasRegion, self->regionsCapacity);
+	}
+	region = self->regions + self->regionsCount++;
+	memset(region, 0, sizeof(spAtlasRegion));
+	return region;
+}
+
+static void _spAtlas_indexRegions(_spAtlas* self) {
+	const char** names = MALLOC(const char*, self->regionsCount > 0 ? self->regionsCount : 1);
+	int i;
+	self->super.regions = self->regionsCount > 0 ? self->regions : 0;
+	for (i = 0; i < self->regionsCount; ++i) {
+		self->regions[i].next = i + 1 < self->regionsCount ? self->regions + i + 1 : 0;
+		names[i] = self->regions[i].name;
+	}
+	_spNameTable_init(&self->regionNames, names, self->regionsCount);
 }
 
 static const char* formatNames[] = { "", "Alpha", "Intensity", "LuminanceAlpha", "RGB565", "RGBA4444", "RGB888", "RGBA8888" };
 static const char* textureFilterNames[] = { "", "Nearest", "Linear", "MipMap", "MipMapNearestNearest", "MipMapLinearNearest",
 "MipMapNearestLinear", "MipMapLinearLinear" };
 
-spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* rendererObject) {
-	spAtlas* self;
+/* Returns 0 on failure. */
+static int _spAtlas_parse(_spAtlas* internal, const char* begin, int length, const char* dir) {
+	spAtlas* self = SUPER(internal);
 
 	int count;
 	const char* end = begin + length;
@@ -174,23 +220,16 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 
 	spAtlasPage *page = 0;
 	spAtlasPage *lastPage = 0;
-	spAtlasRegion *lastRegion = 0;
 	Str str;
 	Str tuple[4];
 
-	self = NEW(spAtlas);
-	self->rendererObject = rendererObject;
-
 	while (readLine(&begin, end, &str)) {
 		if (str.end - str.begin == 0) {
 			page = 0;
 		}
 		else if (!page) {
 			char* name = mallocString(&str);
-			char* path = MALLOC(char, dirLength + needsSlash + strlen(name) + 1);
-			memcpy(path, dir, dirLength);
-			if (needsSlash) path[dirLength] = '/';
-			strcpy(path + dirLength + needsSlash, name);
+			char* path;
 
 			page = spAtlasPage_create(self, name);
 			FREE(name);
@@ -202,19 +241,19 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 
 			switch (readTuple(&begin, end, tuple)) {
 			case 0:
-				return abortAtlas(self);
+				return 0;
 			case 2: /* size is only optional for an atlas packed with an old TexturePacker. */
 				page->width = toInt(tuple);
 				page->height = toInt(tuple + 1);
-				if (!readTuple(&begin, end, tuple)) return abortAtlas(self);
+				if (!readTuple(&begin, end, tuple)) return 0;
 			}
 			page->format = (spAtlasFormat)indexOf(formatNames, 8, tuple);
 
-			if (!readTuple(&begin, end, tuple)) return abortAtlas(self);
+			if (!readTuple(&begin, end, tuple)) return 0;
 			page->minFilter = (spAtlasFilter)indexOf(textureFilterNames, 8, tuple);
 			page->magFilter = (spAtlasFilter)indexOf(textureFilterNames, 8, tuple + 1);
 
-			if (!readValue(&begin, end, &str)) return abortAtlas(self);
+			if (!readValue(&begin, end, &str)) return 0;
 
 			page->uWrap = SP_ATLAS_CLAMPTOEDGE;
 			page->vWrap = SP_ATLAS_CLAMPTOEDGE;
@@ -231,28 +270,26 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 				}
 			}
 
+			path = MALLOC(char, dirLength + needsSlash + strlen(page->name) + 1);
+			memcpy(path, dir, dirLength);
+			if (needsSlash) path[dirLength] = '/';
+			strcpy(path + dirLength + needsSlash, page->name);
 			_spAtlasPage_createTexture(page, path);
 			FREE(path);
 		}
 		else {
-			spAtlasRegion *region = spAtlasRegion_create();
-			if (lastRegion)
-				lastRegion->next = region;
-			else
-				self->regions = region;
-			lastRegion = region;
-
+			spAtlasRegion *region = _spAtlas_addRegion(internal);
 			region->page = page;
-			region->name = mallocString(&str);
+			region->name = arenaString(internal, &str);
 
-			if (!readValue(&begin, end, &str)) return abortAtlas(self);
+			if (!readValue(&begin, end, &str)) return 0;
 			region->rotate = equals(&str, "true");
 
-			if (readTuple(&begin, end, tuple) != 2) return abortAtlas(self);
+			if (readTuple(&begin, end, tuple) != 2) return 0;
 			region->x = toInt(tuple);
 			region->y = toInt(tuple + 1);
 
-			if (readTuple(&begin, end, tuple) != 2) return abortAtlas(self);
+			if (readTuple(&begin, end, tuple) != 2) return 0;
 			region->width = toInt(tuple);
 			region->height = toInt(tuple + 1);
 
@@ -268,39 +305,54 @@ spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* re
 			}
 
 			count = readTuple(&begin, end, tuple);
-			if (!count) return abortAtlas(self);
+			if (!count) return 0;
 			if (count == 4) { /* split is optional */
-				region->splits = MALLOC(int, 4);
-				region->splits[0] = toInt(tuple);
-				region->splits[1] = toInt(tuple + 1);
-				region->splits[2] = toInt(tuple + 2);
-				region->splits[3] = toInt(tuple + 3);
+				region->splits = arenaInts(internal, tuple);
 
 				count = readTuple(&begin, end, tuple);
-				if (!count) return abortAtlas(self);
+				if (!count) return 0;
 				if (count == 4) { /* pad is optional, but only present with splits */
-					region->pads = MALLOC(int, 4);
-					region->pads[0] = toInt(tuple);
-					region->pads[1] = toInt(tuple + 1);
-					region->pads[2] = toInt(tuple + 2);
-					region->pads[3] = toInt(tuple + 3);
+					region->pads = arenaInts(internal, tuple);
 
-					if (!readTuple(&begin, end, tuple)) return abortAtlas(self);
+					if (!readTuple(&begin, end, tuple)) return 0;
 				}
 			}
 
 			region->originalWidth = toInt(tuple);
 			region->originalHeight = toInt(tuple + 1);
 
-			readTuple(&begin, end, tuple);
+			if (!readTuple(&begin, end, tuple)) return 0;
 			region->offsetX = toInt(tuple);
 			region->offsetY = toInt(tuple + 1);
 
-			if (!readValue(&begin, end, &str)) return abortAtlas(self);
+			if (!readValue(&begin, end, &str)) return 0;
 			region->index = toInt(&str);
 		}
 	}
+	return 1;
+}
+
+spAtlas* spAtlas_create(const char* begin, int length, const char* dir, void* rendererObject) {
+	_spAtlas* internal;
+	spAtlas* self;
+	/* The atlas keeps its own arena for region strings, anything else comes from the heap. */
+	_spArena* previous = _spSetArena(0);
 
+	internal = NEW(_spAtlas);
+	self = SUPER(internal);
+	self->rendererObject = rendererObject;
+	/* A region takes around a hundred bytes of text, a fifth of which is its name. */
+	internal->strings = _spArena_create(length / 4);
+	internal->regionsCapacity = length / 96 + 1;
+	internal->regions = MALLOC(spAtlasRegion, internal->regionsCapacity);
+
+	if (!_spAtlas_parse(internal, begin, length, dir)) {
+		spAtlas_dispose(self);
+		self = 0;
+	} else
+		_spAtlas_indexRegions(internal);
+
+	_spSetArena(previous);
 	return self;
 }
 
@@ -331,7 +383,7 @@ spAtlas* spAtlas_createFromFile(const char* path, void* rendererObject) {
 }
 
 void spAtlas_dispose(spAtlas* self) {
-	spAtlasRegion* region, *nextRegion;
+	_spAtlas* internal = SUB_CAST(_spAtlas, self);
 	spAtlasPage* page = self->pages;
 	while (page) {
 		spAtlasPage* nextPage = page->next;
@@ -339,21 +391,15 @@ void spAtlas_dispose(spAtlas* self) {
 		page = nextPage;
 	}
 
-	region = self->regions;
-	while (region) {
-		nextRegion = region->next;
-		spAtlasRegion_dispose(region);
-		region = nextRegion;
-	}
+	FREE(internal->regions);
+	if (internal->strings) _spArena_dispose(internal->strings);
+	_spNameTable_deinit(&internal->regionNames);
 
 	FREE(self);
 }
 
 spAtlasRegion* spAtlas_findRegion(const spAtlas* self, const char* name) {
-	spAtlasRegion* region = self->regions;
-	while (region) {
-		if (strcmp(region->name, name) == 0) return region;
-		region = region->next;
-	}
-	return 0;
+	const _spAtlas* internal = SUB_CAST(_spAtlas, self);
+	int index = _spNameTable_find(&internal->regionNames, name);
+	return index == -1 ? 0 : internal->regions + index;
 }
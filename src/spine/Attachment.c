@@ -55,3 +55,27 @@ void _spAttachment_deinit (spAttachment* self) {
 void spAttachment_dispose (spAttachment* self) {
 	VTABLE(spAttachment, self) ->dispose(self);
 }
+
+void _spRegionAttachment_dispose (spAttachment* attachment);
+void _spBoundingBoxAttachment_dispose (spAttachment* attachment);
+void _spMeshAttachment_dispose (spAttachment* attachment);
+void _spPathAttachment_dispose (spAttachment* attachment);
+void _spPointAttachment_dispose (spAttachment* attachment);
+void _spClippingAttachment_dispose (spAttachment* attachment);
+
+/* Indexed by spAttachmentType. */
+static const _spAttachmentVtable _spAttachmentVtables[] = {
+	{_spRegionAttachment_dispose},
+	{_spBoundingBoxAttachment_dispose},
+	{_spMeshAttachment_dispose},
+	{_spMeshAttachment_dispose},
+	{_spPathAttachment_dispose},
+	{_spPointAttachment_dispose},
+	{_spClippingAttachment_dispose}
+};
+
+int _spAttachment_setSharedVtable (spAttachment* self) {
+	if ((unsigned int)self->type >= sizeof(_spAttachmentVtables) / sizeof(_spAttachmentVtables[0])) return 0;
+	CONST_CAST(const _spAttachmentVtable*, self->vtable) = &_spAttachmentVtables[self->type];
+	return 1;
+}
@@ -46,6 +46,7 @@ spIkConstraint *spIkConstraint_create(spIkConstraintData *data, const spSkeleton
 	for (i = 0; i < self->bonesCount; ++i)
 		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
 	self->target = spSkeleton_findBone(skeleton, self->data->target->name);
+	self->cacheValid = 0;
 
 	return self;
 }
@@ -55,7 +56,89 @@ void spIkConstraint_dispose(spIkConstraint *self) {
 	FREE(self);
 }
 
+static float* _spIkConstraint_writeWorld (const spBone* bone, float* out) {
+	out[0] = bone->a;
+	out[1] = bone->b;
+	out[2] = bone->c;
+	out[3] = bone->d;
+	out[4] = bone->worldX;
+	out[5] = bone->worldY;
+	return out + 6;
+}
+
+static float* _spIkConstraint_writeApplied (const spBone* bone, float* out) {
+	out[0] = bone->ax;
+	out[1] = bone->ay;
+	out[2] = bone->arotation;
+	out[3] = bone->ascaleX;
+	out[4] = bone->ascaleY;
+	out[5] = bone->ashearX;
+	out[6] = bone->ashearY;
+	return out + 7;
+}
+
+static const float* _spIkConstraint_readBone (spBone* bone, const float* in) {
+	CONST_CAST(float, bone->a) = in[0];
+	CONST_CAST(float, bone->b) = in[1];
+	CONST_CAST(float, bone->c) = in[2];
+	CONST_CAST(float, bone->d) = in[3];
+	CONST_CAST(float, bone->worldX) = in[4];
+	CONST_CAST(float, bone->worldY) = in[5];
+	bone->ax = in[6];
+	bone->ay = in[7];
+	bone->arotation = in[8];
+	bone->ascaleX = in[9];
+	bone->ascaleY = in[10];
+	bone->ashearX = in[11];
+	bone->ashearY = in[12];
+	bone->appliedValid = 1;
+	return in + 13;
+}
+
+/* Collects everything the solve reads: the applied transform of the constrained bones, the world transform they are
+ * solved in, the target position, the constraint settings and the skeleton flip. Returns the number of floats written. */
+static int _spIkConstraint_writeInputs (spIkConstraint* self, float* out) {
+	float* start = out;
+	spBone* parent = self->bones[0];
+	if (!parent->appliedValid) spBone_updateAppliedTransform(parent);
+	out = _spIkConstraint_writeWorld(parent->parent, out);
+	out = _spIkConstraint_writeApplied(parent, out);
+	if (self->bonesCount == 2) {
+		spBone* child = self->bones[1];
+		if (!child->appliedValid) spBone_updateAppliedTransform(child);
+		out = _spIkConstraint_writeWorld(parent, out);
+		out = _spIkConstraint_writeApplied(child, out);
+		*out++ = parent->rotation;
+		*out++ = (float)self->bendDirection;
+	}
+	*out++ = self->target->worldX;
+	*out++ = self->target->worldY;
+	*out++ = self->mix;
+	*out++ = (float)parent->skeleton->flipX;
+	*out++ = (float)parent->skeleton->flipY;
+	return (int)(out - start);
+}
+
 void spIkConstraint_apply(spIkConstraint *self) {
+	float inputs[SP_IKCONSTRAINT_CACHE_SIZE];
+	int inputsCount, i;
+
+	if (self->bonesCount != 1 && self->bonesCount != 2) return;
+	if (self->mix == 0) {
+		/* Nothing to solve, the bones keep the world transforms from their applied transforms. */
+		if (self->bonesCount == 2) spBone_updateWorldTransform(self->bones[1]);
+		self->cacheValid = 0;
+		return;
+	}
+
+	inputsCount = _spIkConstraint_writeInputs(self, inputs);
+	if (self->cacheValid && memcmp(inputs, self->cacheInputs, sizeof(float) * inputsCount) == 0) {
+		const float* in = self->cacheOutputs;
+		for (i = 0; i < self->bonesCount; ++i)
+			in = _spIkConstraint_readBone(self->bones[i], in);
+		return;
+	}
+
 	switch (self->bonesCount) {
 		case 1:
 			spIkConstraint_apply1(self->bones[0], self->target->worldX, self->target->worldY, self->mix);
@@ -64,11 +147,22 @@ void spIkConstraint_apply(spIkConstraint *self) {
 			spIkConstraint_apply2(self->bones[0], self->bones[1], self->target->worldX, self->target->worldY, self->bendDirection, self->mix);
 			break;
 	}
+
+	memcpy(self->cacheInputs, inputs, sizeof(float) * inputsCount);
+	{
+		float* out = self->cacheOutputs;
+		for (i = 0; i < self->bonesCount; ++i) {
+			out = _spIkConstraint_writeWorld(self->bones[i], out);
+			out = _spIkConstraint_writeApplied(self->bones[i], out);
+		}
+	}
+	self->cacheValid = 1;
 }
 
 void spIkConstraint_apply1 (spBone* bone, float targetX, float targetY, float alpha) {
 	spBone* p = bone->parent;
 	float id, x, y, tx, ty, rotationIK;
+	if (alpha == 0) return;
 	if (!bone->appliedValid) spBone_updateAppliedTransform(bone);
 	id = 1 / (p->a * p->d - p->b * p->c);
 	x = targetX - p->worldX, y = targetY - p->worldY;
@@ -46,7 +46,15 @@
 #define SPINE_JSON_DEBUG 0
 #endif
 
-static const char* ep;
+static SP_THREAD_LOCAL const char* ep;
+/* Set while Json_createInPlace parses, strings are then unescaped over the input instead of copied. */
+static SP_THREAD_LOCAL int inPlace;
+
+/* A tree parsed in place keeps the arena its nodes were allocated from in the root. */
+typedef struct {
+	Json super;
+	_spArena* arena;
+} _JsonRoot;
 
 const char* Json_getError (void) {
 	return ep;
@@ -90,6 +98,12 @@ void Json_dispose (Json *c) {
 	}
 }
 
+/* Exact powers of ten, dividing by these is cheaper than calling POW for every fraction. */
+static const double powersOf10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
 /* Parse the input text to generate a number, and populate the result into item. */
 static const char* parse_number (Json *item, const char* num) {
 	double result = 0.0;
@@ -116,7 +130,7 @@ static const char* parse_number (Json *item, const char* num) {
 			++ptr;
 			++n;
 		}
-		result += fraction / POW(10.0, n);
+		result += fraction / (n < (int)(sizeof(powersOf10) / sizeof(powersOf10[0])) ? powersOf10[n] : POW(10.0, n));
 	}
 	if (negative) result = -result;
 
@@ -171,11 +185,16 @@ static const char* parse_string (Json *item, const char* str) {
 		return 0;
 	} /* not a string! */
 
-	while (*ptr != '\"' && *ptr && ++len)
-		if (*ptr++ == '\\') ptr++; /* Skip escaped quotes. */
+	if (inPlace) {
+		/* Escapes never unescape to more bytes than they take, so the string can be written over itself. */
+		out = (char*)ptr;
+	} else {
+		while (*ptr != '\"' && *ptr && ++len)
+			if (*ptr++ == '\\') ptr++; /* Skip escaped quotes. */
 
-	out = MALLOC(char, len + 1); /* The length needed for the string, roughly. */
-	if (!out) return 0;
+		out = MALLOC(char, len + 1); /* The length needed for the string, roughly. */
+		if (!out) return 0;
+	}
 
 	ptr = str + 1;
 	ptr2 = out;
@@ -249,8 +268,8 @@ static const char* parse_string (Json *item, const char* str) {
 			ptr++;
 		}
 	}
-	*ptr2 = 0;
 	if (*ptr == '\"') ptr++; /* TODO error handling if not \" or \0 ? */
+	*ptr2 = 0; /* After the quote is checked, in place it may be what gets overwritten. */
 	item->valueString = out;
 	item->type = Json_String;
 	return ptr;
@@ -286,6 +305,34 @@ Json *Json_create (const char* value) {
 	return c;
 }
 
+Json *Json_createInPlace (char* value) {
+	_JsonRoot *root;
+	_spArena *arena, *previous;
+	const char* end;
+	ep = 0;
+	if (!value) return 0;
+
+	/* Blocks double as the tree grows, value isn't measured since parsing stops at the end of the root. */
+	arena = _spArena_create(32 * 1024);
+	previous = _spSetArena(arena);
+	root = NEW(_JsonRoot);
+	root->arena = arena;
+	inPlace = 1;
+	end = parse_value(SUPER(root), skip(value));
+	inPlace = 0;
+	_spSetArena(previous);
+	if (!end) {
+		_spArena_dispose(arena);
+		return 0;
+	} /* parse failure. ep is set. */
+
+	return SUPER(root);
+}
+
+void Json_disposeInPlace (Json* json) {
+	if (json) _spArena_dispose(SUB_CAST(_JsonRoot, json)->arena);
+}
+
 /* Parser core - when encountering text, process appropriately. */
 static const char* parse_value (Json *item, const char* value) {
 	/* Referenced by Json_create(), parse_array(), and parse_object(). */
@@ -440,7 +487,9 @@ static const char* parse_object (Json *item, const char* value) {
 
 Json *Json_getItem (Json *object, const char* string) {
 	Json *c = object->child;
-	while (c && Json_strcasecmp(c->name, string))
+	int first = tolower((unsigned char)*string);
+	/* Most names differ in the first character, only the rest need the full comparison. */
+	while (c && (!c->name || tolower((unsigned char)*c->name) != first || Json_strcasecmp(c->name, string)))
 		c = c->next;
 	return c;
 }
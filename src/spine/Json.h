@@ -67,6 +67,11 @@ Json* Json_create (const char* value);
 /* Delete a Json entity and all subentities. */
 void Json_dispose (Json* json);
 
+/* Like Json_create, but strings are unescaped in value, which must outlive the Json, and nodes come from a single arena.
+ * Call Json_disposeInPlace when finished, never Json_dispose. */
+Json* Json_createInPlace (char* value);
+void Json_disposeInPlace (Json* json);
+
 /* Get item "string" from object. Case insensitive. */
 Json* Json_getItem (Json* json, const char* string);
 const char* Json_getString (Json* json, const char* name, const char* defaultValue);
@@ -37,6 +37,19 @@
 #define PATHCONSTRAINT_AFTER -3
 #define EPSILON 0.00001f
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PATHCONSTRAINT_SSE
+#endif
+
+/* A position on a constant speed path, evaluated after all curves and segments have been resolved. */
+typedef struct _spPathSample {
+	int world; /* index of the curve's first vertex in the world vertices */
+	int out;
+	int/*bool*/ tangent;
+	float p;
+} _spPathSample;
+
 spPathConstraint* spPathConstraint_create (spPathConstraintData* data, const spSkeleton* skeleton) {
 	int i;
 	spPathConstraint *self = NEW(spPathConstraint);
@@ -60,6 +73,12 @@ spPathConstraint* spPathConstraint_create (spPathConstraintData* data, const spS
 	self->curves = 0;
 	self->lengthsCount = 0;
 	self->lengths = 0;
+	self->lastWorldCount = 0;
+	self->lastWorld = 0;
+	self->curveSegmentsCount = 0;
+	self->curveSegments = 0;
+	self->samplesCount = 0;
+	self->samples = 0;
 	return self;
 }
 
@@ -70,6 +89,9 @@ void spPathConstraint_dispose (spPathConstraint* self) {
 	if (self->world) FREE(self->world);
 	if (self->curves) FREE(self->curves);
 	if (self->lengths) FREE(self->lengths);
+	if (self->lastWorld) FREE(self->lastWorld);
+	if (self->curveSegments) FREE(self->curveSegments);
+	if (self->samples) FREE(self->samples);
 	FREE(self);
 }
 
@@ -225,9 +247,95 @@ static void _addCurvePosition (float p, float x1, float y1, float cx1, float cy1
 	if (tangents) out[o + 2] = ATAN2(y - (y1 * uu + cy1 * ut * 2 + cy2 * tt), x - (x1 * uu + cx1 * ut * 2 + cx2 * tt));
 }
 
+/* Returns the arc length table of a constant speed path curve, computing it if the world vertices changed since. */
+static float* _spPathConstraint_getCurveSegments (spPathConstraint* self, const float* world, int curve) {
+	float* segments = self->curveSegments + curve * 10;
+	float x1, y1, cx1, cy1, cx2, cy2, x2, y2;
+	float tmpx, tmpy, dddfx, dddfy, ddfx, ddfy, dfx, dfy, curveLength;
+	int ii;
+	if (segments[9] >= 0) return segments;
+
+	ii = curve * 6;
+	x1 = world[ii];
+	y1 = world[ii + 1];
+	cx1 = world[ii + 2];
+	cy1 = world[ii + 3];
+	cx2 = world[ii + 4];
+	cy2 = world[ii + 5];
+	x2 = world[ii + 6];
+	y2 = world[ii + 7];
+	tmpx = (x1 - cx1 * 2 + cx2) * 0.03f;
+	tmpy = (y1 - cy1 * 2 + cy2) * 0.03f;
+	dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.006f;
+	dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.006f;
+	ddfx = tmpx * 2 + dddfx;
+	ddfy = tmpy * 2 + dddfy;
+	dfx = (cx1 - x1) * 0.3f + tmpx + dddfx * 0.16666667f;
+	dfy = (cy1 - y1) * 0.3f + tmpy + dddfy * 0.16666667f;
+	curveLength = SQRT(dfx * dfx + dfy * dfy);
+	segments[0] = curveLength;
+	for (ii = 1; ii < 8; ii++) {
+		dfx += ddfx;
+		dfy += ddfy;
+		ddfx += dddfx;
+		ddfy += dddfy;
+		curveLength += SQRT(dfx * dfx + dfy * dfy);
+		segments[ii] = curveLength;
+	}
+	dfx += ddfx;
+	dfy += ddfy;
+	curveLength += SQRT(dfx * dfx + dfy * dfy);
+	segments[8] = curveLength;
+	dfx += ddfx + dddfx;
+	dfy += ddfy + dddfy;
+	curveLength += SQRT(dfx * dfx + dfy * dfy);
+	segments[9] = curveLength;
+	return segments;
+}
+
+/* Evaluates the Bezier curve at each sample, four samples at a time when SSE is available. */
+static void _spPathConstraint_addCurvePositions (const float* world, const _spPathSample* samples, int samplesCount, float* out) {
+	int i = 0;
+#ifdef PATHCONSTRAINT_SSE
+	float x[4], y[4], tx[4], ty[4];
+	int j;
+	for (; i + 4 <= samplesCount; i += 4) {
+		const _spPathSample* s = samples + i;
+		const float* w0 = world + s[0].world, *w1 = world + s[1].world, *w2 = world + s[2].world, *w3 = world + s[3].world;
+		__m128 p = _mm_set_ps(s[3].p, s[2].p, s[1].p, s[0].p);
+		__m128 x1 = _mm_set_ps(w3[0], w2[0], w1[0], w0[0]), y1 = _mm_set_ps(w3[1], w2[1], w1[1], w0[1]);
+		__m128 cx1 = _mm_set_ps(w3[2], w2[2], w1[2], w0[2]), cy1 = _mm_set_ps(w3[3], w2[3], w1[3], w0[3]);
+		__m128 cx2 = _mm_set_ps(w3[4], w2[4], w1[4], w0[4]), cy2 = _mm_set_ps(w3[5], w2[5], w1[5], w0[5]);
+		__m128 x2 = _mm_set_ps(w3[6], w2[6], w1[6], w0[6]), y2 = _mm_set_ps(w3[7], w2[7], w1[7], w0[7]);
+		__m128 three = _mm_set1_ps(3), two = _mm_set1_ps(2);
+		__m128 tt = _mm_mul_ps(p, p), ttt = _mm_mul_ps(tt, p), u = _mm_sub_ps(_mm_set1_ps(1), p);
+		__m128 uu = _mm_mul_ps(u, u), uuu = _mm_mul_ps(uu, u);
+		__m128 ut = _mm_mul_ps(u, p), ut3 = _mm_mul_ps(ut, three), uut3 = _mm_mul_ps(u, ut3), utt3 = _mm_mul_ps(ut3, p);
+		_mm_storeu_ps(x, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, uuu), _mm_mul_ps(cx1, uut3)), _mm_mul_ps(cx2, utt3)),
+			_mm_mul_ps(x2, ttt)));
+		_mm_storeu_ps(y, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(y1, uuu), _mm_mul_ps(cy1, uut3)), _mm_mul_ps(cy2, utt3)),
+			_mm_mul_ps(y2, ttt)));
+		_mm_storeu_ps(tx, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, uu), _mm_mul_ps(_mm_mul_ps(cx1, ut), two)), _mm_mul_ps(cx2, tt)));
+		_mm_storeu_ps(ty, _mm_add_ps(_mm_add_ps(_mm_mul_ps(y1, uu), _mm_mul_ps(_mm_mul_ps(cy1, ut), two)), _mm_mul_ps(cy2, tt)));
+		for (j = 0; j < 4; j++) {
+			int o = s[j].out;
+			out[o] = x[j];
+			out[o + 1] = y[j];
+			if (s[j].tangent) out[o + 2] = ATAN2(y[j] - ty[j], x[j] - tx[j]);
+		}
+	}
+#endif
+	for (; i < samplesCount; i++) {
+		const float* w = world + samples[i].world;
+		_addCurvePosition(samples[i].p, w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7], out, samples[i].out, samples[i].tangent);
+	}
+}
+
 float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAttachment* path, int spacesCount, int/*bool*/ tangents, int/*bool*/percentPosition, int/**/percentSpacing) {
 	int i, o, w, curve, segment, /*bool*/closed, verticesLength, curveCount, prevCurve;
 	float* out, *curves, *segments;
+	_spPathSample* samples;
+	int samplesCount;
 	float tmpx, tmpy, dddfx, dddfy, ddfx, ddfy, dfx, dfy, pathLength, curveLength, p;
 	float x1, y1, cx1, cy1, cx2, cy2, x2, y2;
 	spSlot* target = self->target;
@@ -333,53 +441,78 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 		spVertexAttachment_computeWorldVertices(SUPER(path), target, 2, verticesLength, world, 0, 2);
 	}
 
-	/* Curve lengths. */
+	/* Curve lengths, only recomputed when the world vertices changed. */
 	if (self->curvesCount != curveCount) {
 		if (self->curves) FREE(self->curves);
 		self->curves = MALLOC(float, curveCount);
 		self->curvesCount = curveCount;
+		if (self->curveSegments) FREE(self->curveSegments);
+		self->curveSegments = MALLOC(float, curveCount * 10);
+		self->curveSegmentsCount = curveCount * 10;
+		self->lastWorldCount = 0;
 	}
 	curves = self->curves;
-	pathLength = 0;
-	x1 = world[0], y1 = world[1], cx1 = 0, cy1 = 0, cx2 = 0, cy2 = 0, x2 = 0, y2 = 0;
-	for (i = 0, w = 2; i < curveCount; i++, w += 6) {
-		cx1 = world[w];
-		cy1 = world[w + 1];
-		cx2 = world[w + 2];
-		cy2 = world[w + 3];
-		x2 = world[w + 4];
-		y2 = world[w + 5];
-		tmpx = (x1 - cx1 * 2 + cx2) * 0.1875f;
-		tmpy = (y1 - cy1 * 2 + cy2) * 0.1875f;
-		dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.09375f;
-		dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.09375f;
-		ddfx = tmpx * 2 + dddfx;
-		ddfy = tmpy * 2 + dddfy;
-		dfx = (cx1 - x1) * 0.75f + tmpx + dddfx * 0.16666667f;
-		dfy = (cy1 - y1) * 0.75f + tmpy + dddfy * 0.16666667f;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx;
-		dfy += ddfy;
-		ddfx += dddfx;
-		ddfy += dddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx;
-		dfy += ddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		dfx += ddfx + dddfx;
-		dfy += ddfy + dddfy;
-		pathLength += SQRT(dfx * dfx + dfy * dfy);
-		curves[i] = pathLength;
-		x1 = x2;
-		y1 = y2;
+	if (self->lastWorldCount != verticesLength || memcmp(self->lastWorld, world, sizeof(float) * verticesLength) != 0) {
+		if (self->lastWorldCount != verticesLength) {
+			if (self->lastWorld) FREE(self->lastWorld);
+			self->lastWorld = MALLOC(float, verticesLength);
+			self->lastWorldCount = verticesLength;
+		}
+		memcpy(self->lastWorld, world, sizeof(float) * verticesLength);
+
+		pathLength = 0;
+		x1 = world[0], y1 = world[1], cx1 = 0, cy1 = 0, cx2 = 0, cy2 = 0, x2 = 0, y2 = 0;
+		for (i = 0, w = 2; i < curveCount; i++, w += 6) {
+			cx1 = world[w];
+			cy1 = world[w + 1];
+			cx2 = world[w + 2];
+			cy2 = world[w + 3];
+			x2 = world[w + 4];
+			y2 = world[w + 5];
+			tmpx = (x1 - cx1 * 2 + cx2) * 0.1875f;
+			tmpy = (y1 - cy1 * 2 + cy2) * 0.1875f;
+			dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.09375f;
+			dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.09375f;
+			ddfx = tmpx * 2 + dddfx;
+			ddfy = tmpy * 2 + dddfy;
+			dfx = (cx1 - x1) * 0.75f + tmpx + dddfx * 0.16666667f;
+			dfy = (cy1 - y1) * 0.75f + tmpy + dddfy * 0.16666667f;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx;
+			dfy += ddfy;
+			ddfx += dddfx;
+			ddfy += dddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx;
+			dfy += ddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			dfx += ddfx + dddfx;
+			dfy += ddfy + dddfy;
+			pathLength += SQRT(dfx * dfx + dfy * dfy);
+			curves[i] = pathLength;
+			x1 = x2;
+			y1 = y2;
+
+			/* Segment lengths are computed on first use. */
+			self->curveSegments[i * 10 + 9] = -1;
+		}
 	}
+	pathLength = curveCount > 0 ? curves[curveCount - 1] : 0;
 	if (percentPosition) position *= pathLength;
 	if (percentSpacing) {
 		for (i = 0; i < spacesCount; i++)
 			spaces[i] *= pathLength;
 	}
 
-	segments = self->segments;
+	if (self->samplesCount < spacesCount) {
+		if (self->samples) FREE(self->samples);
+		self->samples = MALLOC(_spPathSample, spacesCount);
+		self->samplesCount = spacesCount;
+	}
+	samples = self->samples;
+	samplesCount = 0;
+
+	segments = 0;
 	curveLength = 0;
 	for (i = 0, o = 0, curve = 0, segment = 0; i < spacesCount; i++, o += 3) {
 		float space = spaces[i];
@@ -413,43 +546,9 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 
 		/* Curve segment lengths. */
 		if (curve != prevCurve) {
-			int ii;
 			prevCurve = curve;
-			ii = curve * 6;
-			x1 = world[ii];
-			y1 = world[ii + 1];
-			cx1 = world[ii + 2];
-			cy1 = world[ii + 3];
-			cx2 = world[ii + 4];
-			cy2 = world[ii + 5];
-			x2 = world[ii + 6];
-			y2 = world[ii + 7];
-			tmpx = (x1 - cx1 * 2 + cx2) * 0.03f;
-			tmpy = (y1 - cy1 * 2 + cy2) * 0.03f;
-			dddfx = ((cx1 - cx2) * 3 - x1 + x2) * 0.006f;
-			dddfy = ((cy1 - cy2) * 3 - y1 + y2) * 0.006f;
-			ddfx = tmpx * 2 + dddfx;
-			ddfy = tmpy * 2 + dddfy;
-			dfx = (cx1 - x1) * 0.3f + tmpx + dddfx * 0.16666667f;
-			dfy = (cy1 - y1) * 0.3f + tmpy + dddfy * 0.16666667f;
-			curveLength = SQRT(dfx * dfx + dfy * dfy);
-			segments[0] = curveLength;
-			for (ii = 1; ii < 8; ii++) {
-				dfx += ddfx;
-				dfy += ddfy;
-				ddfx += dddfx;
-				ddfy += dddfy;
-				curveLength += SQRT(dfx * dfx + dfy * dfy);
-				segments[ii] = curveLength;
-			}
-			dfx += ddfx;
-			dfy += ddfy;
-			curveLength += SQRT(dfx * dfx + dfy * dfy);
-			segments[8] = curveLength;
-			dfx += ddfx + dddfx;
-			dfy += ddfy + dddfy;
-			curveLength += SQRT(dfx * dfx + dfy * dfy);
-			segments[9] = curveLength;
+			segments = _spPathConstraint_getCurveSegments(self, world, curve);
+			curveLength = segments[9];
 			segment = 0;
 		}
 
@@ -466,7 +565,15 @@ float* spPathConstraint_computeWorldPositions(spPathConstraint* self, spPathAtta
 			}
 			break;
 		}
-		_addCurvePosition(p * 0.1f, x1, y1, cx1, cy1, cx2, cy2, x2, y2, out, o, tangents || (i > 0 && space == 0));
+
+		p *= 0.1f;
+		if (p == 0 || _isNan(p, 0)) p = 0.0001f;
+		samples[samplesCount].world = curve * 6;
+		samples[samplesCount].out = o;
+		samples[samplesCount].tangent = tangents || (i > 0 && space == 0);
+		samples[samplesCount].p = p;
+		samplesCount++;
 	}
+	_spPathConstraint_addCurvePositions(world, samples, samplesCount, out);
 	return out;
 }
@@ -52,6 +52,10 @@ typedef struct {
 	int updateCacheResetCount;
 	int updateCacheResetCapacity;
 	spBone** updateCacheReset;
+
+	/* Where spSkeleton_updateIkConstraints starts in updateCache and updateCacheReset. */
+	int ikUpdateStart;
+	int ikUpdateResetStart;
 } _spSkeleton;
 
 spSkeleton* spSkeleton_create (spSkeletonData* data) {
@@ -228,6 +232,10 @@ static void _sortIkConstraint (_spSkeleton* const internal, spIkConstraint* cons
 	spBone* target = constraint->target;
 	spBone** constrained;
 	spBone* parent;
+	if (internal->ikUpdateStart == -1) {
+		internal->ikUpdateStart = internal->updateCacheCount;
+		internal->ikUpdateResetStart = internal->updateCacheResetCount;
+	}
 	_sortBone(internal, target);
 
 	constrained = constraint->bones;
@@ -312,6 +320,7 @@ static void _sortTransformConstraint(_spSkeleton* const internal, spTransformCon
 			_sortBone(internal, constrained[i]);
 	}
 
+	_spTransformConstraint_updateApply(constraint);
 	_addToUpdateCache(internal, SP_UPDATE_TRANSFORM_CONSTRAINT, constraint);
 
 	for (i = 0; i < boneCount; i++)
@@ -320,6 +329,48 @@ static void _sortTransformConstraint(_spSkeleton* const internal, spTransformCon
 		constrained[i]->sorted = 1;
 }
 
+static int/*bool*/ _anyUpdated (const int* updated, spBone** bones, int bonesCount) {
+	int i;
+	for (i = 0; i < bonesCount; ++i)
+		if (updated[bones[i]->data->index]) return 1;
+	return 0;
+}
+
+/* Starting at the first IK constraint gives the same pose as a full update only if what is updated before it is never changed
+ * after it. Otherwise spSkeleton_updateIkConstraints runs the whole cache. */
+static void _checkIkUpdateStart (_spSkeleton* const internal) {
+	int i, changed = 0;
+	int* updated;
+	if (internal->ikUpdateStart <= 0) return;
+	updated = CALLOC(int, internal->super.bonesCount);
+	for (i = 0; i < internal->ikUpdateStart; ++i) {
+		_spUpdate* update = internal->updateCache + i;
+		if (update->type == SP_UPDATE_BONE) updated[((spBone*)update->object)->data->index] = 1;
+	}
+	for (i = internal->ikUpdateStart; i < internal->updateCacheCount && !changed; ++i) {
+		_spUpdate* update = internal->updateCache + i;
+		switch (update->type) {
+		case SP_UPDATE_BONE:
+			changed = updated[((spBone*)update->object)->data->index];
+			break;
+		case SP_UPDATE_IK_CONSTRAINT:
+			changed = _anyUpdated(updated, ((spIkConstraint*)update->object)->bones, ((spIkConstraint*)update->object)->bonesCount);
+			break;
+		case SP_UPDATE_TRANSFORM_CONSTRAINT:
+			changed = _anyUpdated(updated, ((spTransformConstraint*)update->object)->bones, ((spTransformConstraint*)update->object)->bonesCount);
+			break;
+		case SP_UPDATE_PATH_CONSTRAINT:
+			changed = _anyUpdated(updated, ((spPathConstraint*)update->object)->bones, ((spPathConstraint*)update->object)->bonesCount);
+			break;
+		}
+	}
+	FREE(updated);
+	if (changed) {
+		internal->ikUpdateStart = 0;
+		internal->ikUpdateResetStart = 0;
+	}
+}
+
 void spSkeleton_updateCache (spSkeleton* self) {
 	int i, ii;
 	spBone** bones;
@@ -338,6 +389,8 @@ void spSkeleton_updateCache (spSkeleton* self) {
 	FREE(internal->updateCacheReset);
 	internal->updateCacheReset = MALLOC(spBone*, internal->updateCacheResetCapacity);
 	internal->updateCacheResetCount = 0;
+	internal->ikUpdateStart = -1;
+	internal->ikUpdateResetStart = 0;
 
 	bones = self->bones;
 	for (i = 0; i < self->bonesCount; ++i)
@@ -383,13 +436,20 @@ void spSkeleton_updateCache (spSkeleton* self) {
 
 	for (i = 0; i < self->bonesCount; ++i)
 		_sortBone(internal, self->bones[i]);
+
+	/* Without IK constraints there is nothing to update. */
+	if (internal->ikUpdateStart == -1) {
+		internal->ikUpdateStart = internal->updateCacheCount;
+		internal->ikUpdateResetStart = internal->updateCacheResetCount;
+	}
+	_checkIkUpdateStart(internal);
 }
 
-void spSkeleton_updateWorldTransform (const spSkeleton* self) {
+/* Runs the update cache from start, after resetting the applied transforms from resetStart. */
+static void _spSkeleton_update (_spSkeleton* internal, int start, int resetStart) {
 	int i;
-	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
 	spBone** updateCacheReset = internal->updateCacheReset;
-	for (i = 0; i < internal->updateCacheResetCount; i++) {
+	for (i = resetStart; i < internal->updateCacheResetCount; i++) {
 		spBone* bone = updateCacheReset[i];
 		CONST_CAST(float, bone->ax) = bone->x;
 		CONST_CAST(float, bone->ay) = bone->y;
@@ -401,7 +461,7 @@ void spSkeleton_updateWorldTransform (const spSkeleton* self) {
 		CONST_CAST(int, bone->appliedValid) = 1;
 	}
 
-	for (i = 0; i < internal->updateCacheCount; ++i) {
+	for (i = start; i < internal->updateCacheCount; ++i) {
 		_spUpdate* update = internal->updateCache + i;
 		switch (update->type) {
 		case SP_UPDATE_BONE:
@@ -420,6 +480,15 @@ void spSkeleton_updateWorldTransform (const spSkeleton* self) {
 	}
 }
 
+void spSkeleton_updateWorldTransform (const spSkeleton* self) {
+	_spSkeleton_update(SUB_CAST(_spSkeleton, self), 0, 0);
+}
+
+void spSkeleton_updateIkConstraints (const spSkeleton* self) {
+	_spSkeleton* internal = SUB_CAST(_spSkeleton, self);
+	_spSkeleton_update(internal, internal->ikUpdateStart, internal->ikUpdateResetStart);
+}
+
 void spSkeleton_setToSetupPose (const spSkeleton* self) {
 	spSkeleton_setBonesToSetupPose(self);
 	spSkeleton_setSlotsToSetupPose(self);
@@ -462,32 +531,24 @@ void spSkeleton_setSlotsToSetupPose (const spSkeleton* self) {
 		spSlot_setToSetupPose(self->slots[i]);
 }
 
+/* Bones, slots and constraints have the same indices as their data, so lookups use the SkeletonData name index. */
+
 spBone* spSkeleton_findBone (const spSkeleton* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->data->bones[i]->name, boneName) == 0) return self->bones[i];
-	return 0;
+	int index = spSkeletonData_findBoneIndex(self->data, boneName);
+	return index == -1 ? 0 : self->bones[index];
 }
 
 int spSkeleton_findBoneIndex (const spSkeleton* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->data->bones[i]->name, boneName) == 0) return i;
-	return -1;
+	return spSkeletonData_findBoneIndex(self->data, boneName);
 }
 
 spSlot* spSkeleton_findSlot (const spSkeleton* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->data->slots[i]->name, slotName) == 0) return self->slots[i];
-	return 0;
+	int index = spSkeletonData_findSlotIndex(self->data, slotName);
+	return index == -1 ? 0 : self->slots[index];
 }
 
 int spSkeleton_findSlotIndex (const spSkeleton* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->data->slots[i]->name, slotName) == 0) return i;
-	return -1;
+	return spSkeletonData_findSlotIndex(self->data, slotName);
 }
 
 int spSkeleton_setSkinByName (spSkeleton* self, const char* skinName) {
@@ -540,44 +601,151 @@ spAttachment* spSkeleton_getAttachmentForSlotIndex (const spSkeleton* self, int
 }
 
 int spSkeleton_setAttachment (spSkeleton* self, const char* slotName, const char* attachmentName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i) {
-		spSlot *slot = self->slots[i];
-		if (strcmp(slot->data->name, slotName) == 0) {
-			if (!attachmentName)
-				spSlot_setAttachment(slot, 0);
-			else {
-				spAttachment* attachment = spSkeleton_getAttachmentForSlotIndex(self, i, attachmentName);
-				if (!attachment) return 0;
-				spSlot_setAttachment(slot, attachment);
-			}
-			return 1;
-		}
+	spSlot *slot;
+	int i = spSkeletonData_findSlotIndex(self->data, slotName);
+	if (i == -1) return 0;
+	slot = self->slots[i];
+	if (!attachmentName)
+		spSlot_setAttachment(slot, 0);
+	else {
+		spAttachment* attachment = spSkeleton_getAttachmentForSlotIndex(self, i, attachmentName);
+		if (!attachment) return 0;
+		spSlot_setAttachment(slot, attachment);
 	}
-	return 0;
+	return 1;
 }
 
 spIkConstraint* spSkeleton_findIkConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		if (strcmp(self->ikConstraints[i]->data->name, constraintName) == 0) return self->ikConstraints[i];
-	return 0;
+	int index = spSkeletonData_findIkConstraintIndex(self->data, constraintName);
+	return index == -1 ? 0 : self->ikConstraints[index];
 }
 
 spTransformConstraint* spSkeleton_findTransformConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		if (strcmp(self->transformConstraints[i]->data->name, constraintName) == 0) return self->transformConstraints[i];
-	return 0;
+	int index = spSkeletonData_findTransformConstraintIndex(self->data, constraintName);
+	return index == -1 ? 0 : self->transformConstraints[index];
 }
 
 spPathConstraint* spSkeleton_findPathConstraint (const spSkeleton* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->pathConstraintsCount; ++i)
-		if (strcmp(self->pathConstraints[i]->data->name, constraintName) == 0) return self->pathConstraints[i];
-	return 0;
+	int index = spSkeletonData_findPathConstraintIndex(self->data, constraintName);
+	return index == -1 ? 0 : self->pathConstraints[index];
 }
 
 void spSkeleton_update (spSkeleton* self, float deltaTime) {
 	self->time += deltaTime;
 }
+
+#define SKELETON_STATE_VERSION 1
+
+static void _spSkeleton_writeState (const spSkeleton* self, _spStateBuffer* buffer) {
+	int i;
+	_spStateBuffer_writeInt(buffer, SKELETON_STATE_VERSION);
+	_spStateBuffer_writeInt(buffer, self->bonesCount);
+	_spStateBuffer_writeInt(buffer, self->slotsCount);
+	_spStateBuffer_writeInt(buffer, self->ikConstraintsCount);
+	_spStateBuffer_writeInt(buffer, self->transformConstraintsCount);
+	_spStateBuffer_writeInt(buffer, self->pathConstraintsCount);
+
+	_spStateBuffer_write(buffer, &self->skin, sizeof(spSkin*));
+	_spStateBuffer_write(buffer, &self->color, sizeof(spColor));
+	_spStateBuffer_write(buffer, &self->time, sizeof(float));
+	_spStateBuffer_writeInt(buffer, self->flipX);
+	_spStateBuffer_writeInt(buffer, self->flipY);
+	_spStateBuffer_write(buffer, &self->x, sizeof(float));
+	_spStateBuffer_write(buffer, &self->y, sizeof(float));
+
+	for (i = 0; i < self->bonesCount; ++i)
+		/* x, y, rotation, scaleX, scaleY, shearX, shearY are laid out in order. */
+		_spStateBuffer_write(buffer, &self->bones[i]->x, sizeof(float) * 7);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		float attachmentTime = spSlot_getAttachmentTime(slot);
+		_spStateBuffer_write(buffer, &slot->color, sizeof(spColor));
+		if (slot->darkColor) _spStateBuffer_write(buffer, slot->darkColor, sizeof(spColor));
+		_spStateBuffer_write(buffer, &slot->attachment, sizeof(spAttachment*));
+		_spStateBuffer_write(buffer, &attachmentTime, sizeof(float));
+		_spStateBuffer_writeInt(buffer, slot->attachmentVerticesCount);
+		_spStateBuffer_write(buffer, slot->attachmentVertices, sizeof(float) * slot->attachmentVerticesCount);
+	}
+	_spStateBuffer_write(buffer, self->drawOrder, sizeof(spSlot*) * self->slotsCount);
+
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		_spStateBuffer_writeInt(buffer, self->ikConstraints[i]->bendDirection);
+		_spStateBuffer_write(buffer, &self->ikConstraints[i]->mix, sizeof(float));
+	}
+	for (i = 0; i < self->transformConstraintsCount; ++i)
+		/* rotateMix, translateMix, scaleMix, shearMix */
+		_spStateBuffer_write(buffer, &self->transformConstraints[i]->rotateMix, sizeof(float) * 4);
+	for (i = 0; i < self->pathConstraintsCount; ++i)
+		/* position, spacing, rotateMix, translateMix */
+		_spStateBuffer_write(buffer, &self->pathConstraints[i]->position, sizeof(float) * 4);
+}
+
+int spSkeleton_saveState (const spSkeleton* self, void* buffer, int capacity) {
+	_spStateBuffer state;
+	_spStateBuffer_init(&state, buffer, capacity);
+	_spSkeleton_writeState(self, &state);
+	return state.size;
+}
+
+int spSkeleton_loadState (spSkeleton* self, const void* buffer, int size) {
+	int i;
+	_spStateBuffer state;
+	_spStateBuffer_init(&state, buffer, size);
+
+	/* Check the whole layout before changing anything. */
+	_spStateBuffer_expectInt(&state, SKELETON_STATE_VERSION);
+	_spStateBuffer_expectInt(&state, self->bonesCount);
+	_spStateBuffer_expectInt(&state, self->slotsCount);
+	_spStateBuffer_expectInt(&state, self->ikConstraintsCount);
+	_spStateBuffer_expectInt(&state, self->transformConstraintsCount);
+	_spStateBuffer_expectInt(&state, self->pathConstraintsCount);
+	if (state.error) return 0;
+
+	_spStateBuffer_read(&state, &CONST_CAST(spSkin*, self->skin), sizeof(spSkin*));
+	_spStateBuffer_read(&state, &self->color, sizeof(spColor));
+	_spStateBuffer_read(&state, &self->time, sizeof(float));
+	self->flipX = _spStateBuffer_readInt(&state);
+	self->flipY = _spStateBuffer_readInt(&state);
+	_spStateBuffer_read(&state, &self->x, sizeof(float));
+	_spStateBuffer_read(&state, &self->y, sizeof(float));
+
+	for (i = 0; i < self->bonesCount; ++i)
+		_spStateBuffer_read(&state, &self->bones[i]->x, sizeof(float) * 7);
+
+	for (i = 0; i < self->slotsCount; ++i) {
+		spSlot* slot = self->slots[i];
+		spAttachment* attachment = 0;
+		float attachmentTime = 0;
+		int verticesCount;
+		_spStateBuffer_read(&state, &slot->color, sizeof(spColor));
+		if (slot->darkColor) _spStateBuffer_read(&state, slot->darkColor, sizeof(spColor));
+		_spStateBuffer_read(&state, &attachment, sizeof(spAttachment*));
+		_spStateBuffer_read(&state, &attachmentTime, sizeof(float));
+		verticesCount = _spStateBuffer_readInt(&state);
+		if (state.error || verticesCount < 0) return 0;
+		spSlot_setAttachment(slot, attachment);
+		spSlot_setAttachmentTime(slot, attachmentTime);
+		if (slot->attachmentVerticesCapacity < verticesCount) {
+			FREE(slot->attachmentVertices);
+			slot->attachmentVertices = MALLOC(float, verticesCount);
+			slot->attachmentVerticesCapacity = verticesCount;
+		}
+		slot->attachmentVerticesCount = verticesCount;
+		_spStateBuffer_read(&state, slot->attachmentVertices, sizeof(float) * verticesCount);
+	}
+	_spStateBuffer_read(&state, self->drawOrder, sizeof(spSlot*) * self->slotsCount);
+
+	for (i = 0; i < self->ikConstraintsCount; ++i) {
+		self->ikConstraints[i]->bendDirection = _spStateBuffer_readInt(&state);
+		_spStateBuffer_read(&state, &self->ikConstraints[i]->mix, sizeof(float));
+	}
+	for (i = 0; i < self->transformConstraintsCount; ++i)
+		_spStateBuffer_read(&state, &self->transformConstraints[i]->rotateMix, sizeof(float) * 4);
+	for (i = 0; i < self->pathConstraintsCount; ++i)
+		_spStateBuffer_read(&state, &self->pathConstraints[i]->position, sizeof(float) * 4);
+
+	return state.error ? 0 : state.size;
+}
+
+#undef SKELETON_STATE_VERSION
@@ -54,6 +54,9 @@ typedef struct {
 	int linkedMeshCount;
 	int linkedMeshCapacity;
 	_spLinkedMesh* linkedMeshes;
+
+	/* Skins by their index in the data being read, 0 for the skins skipped. */
+	spSkin** skins;
 } _spSkeletonBinary;
 
 spSkeletonBinary* spSkeletonBinary_createWithLoader (spAttachmentLoader* attachmentLoader) {
@@ -71,13 +74,8 @@ spSkeletonBinary* spSkeletonBinary_create (spAtlas* atlas) {
 }
 
 void spSkeletonBinary_dispose (spSkeletonBinary* self) {
-	int i;
 	_spSkeletonBinary* internal = SUB_CAST(_spSkeletonBinary, self);
 	if (internal->ownsLoader) spAttachmentLoader_dispose(self->attachmentLoader);
-	for (i = 0; i < internal->linkedMeshCount; ++i) {
-		FREE(internal->linkedMeshes[i].parent);
-		FREE(internal->linkedMeshes[i].skin);
-	}
 	FREE(internal->linkedMeshes);
 	FREE(self->error);
 	FREE(self);
@@ -86,11 +84,13 @@ void spSkeletonBinary_dispose (spSkeletonBinary* self) {
 void _spSkeletonBinary_setError (spSkeletonBinary* self, const char* value1, const char* value2) {
 	char message[256];
 	int length;
+	_spArena* arena = _spSetArena(0);
 	FREE(self->error);
 	strcpy(message, value1);
 	length = (int)strlen(value1);
 	if (value2) strncat(message + length, value2, 255 - length);
 	MALLOC_STR(self->error, message);
+	_spSetArena(arena);
 }
 
 static unsigned char readByte (_dataInput* input) {
@@ -106,14 +106,9 @@ static int readBoolean (_dataInput* input) {
 }
 
 static int readInt (_dataInput* input) {
-	int result = readByte(input);
-	result <<= 8;
-	result |= readByte(input);
-	result <<= 8;
-	result |= readByte(input);
-	result <<= 8;
-	result |= readByte(input);
-	return result;
+	const unsigned char* bytes = input->cursor;
+	input->cursor += 4;
+	return (int)(((unsigned int)bytes[0] << 24) | ((unsigned int)bytes[1] << 16) | ((unsigned int)bytes[2] << 8) | bytes[3]);
 }
 
 static int readVarint (_dataInput* input, int/*bool*/optimizePositive) {
@@ -158,6 +153,21 @@ char* readString (_dataInput* input) {
 	return string;
 }
 
+/* Decodes a string without copying it: the characters are moved back over the length prefix and terminated in place. The
+ * result points into the input, which must be writable, and must not be freed. */
+static const char* readStringRef (_dataInput* input) {
+	int length = readVarint(input, 1);
+	char* string;
+	if (length == 0) {
+		return 0;
+	}
+	string = (char*)input->cursor - 1;
+	memmove(string, input->cursor, length - 1);
+	input->cursor += length - 1;
+	string[length - 1] = '\0';
+	return string;
+}
+
 static void readColor (_dataInput* input, float *r, float *g, float *b, float *a) {
 	*r = readByte(input) / 255.0f;
 	*g = readByte(input) / 255.0f;
@@ -221,6 +231,230 @@ static void readCurve (_dataInput* input, spCurveTimeline* timeline, int frameIn
 	}
 }
 
+/* The skip functions move past data the same way the read functions do, without creating anything. */
+
+static void skipString (_dataInput* input) {
+	int length = readVarint(input, 1);
+	if (length) input->cursor += length - 1;
+}
+
+static void skipShortArray (_dataInput* input) {
+	input->cursor += readVarint(input, 1) << 1;
+}
+
+/* Frames of frameSize bytes, each but the last followed by a curve. */
+static void skipFrames (_dataInput* input, int frameCount, int frameSize) {
+	int frameIndex;
+	for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+		input->cursor += frameSize;
+		if (frameIndex < frameCount - 1 && readByte(input) == CURVE_BEZIER) input->cursor += 16;
+	}
+}
+
+static void skipVertices (_dataInput* input, int vertexCount) {
+	int i, boneCount;
+	if (!readBoolean(input)) {
+		input->cursor += vertexCount << 3;
+		return;
+	}
+	for (i = 0; i < vertexCount; ++i)
+		for (boneCount = readVarint(input, 1); boneCount > 0; --boneCount) {
+			readVarint(input, 1);
+			input->cursor += 12;
+		}
+}
+
+static void skipAttachment (_dataInput* input, int/*bool*/ nonessential) {
+	int vertexCount;
+	skipString(input);
+	switch ((spAttachmentType)readByte(input)) {
+		case SP_ATTACHMENT_REGION:
+			skipString(input);
+			input->cursor += 32;
+			break;
+		case SP_ATTACHMENT_BOUNDING_BOX:
+			skipVertices(input, readVarint(input, 1));
+			if (nonessential) input->cursor += 4;
+			break;
+		case SP_ATTACHMENT_MESH:
+			skipString(input);
+			input->cursor += 4;
+			vertexCount = readVarint(input, 1);
+			input->cursor += vertexCount << 3;
+			skipShortArray(input);
+			skipVertices(input, vertexCount);
+			readVarint(input, 1);
+			if (nonessential) {
+				skipShortArray(input);
+				input->cursor += 8;
+			}
+			break;
+		case SP_ATTACHMENT_LINKED_MESH:
+			skipString(input);
+			input->cursor += 4;
+			skipString(input);
+			skipString(input);
+			input->cursor += 1;
+			if (nonessential) input->cursor += 8;
+			break;
+		case SP_ATTACHMENT_PATH:
+			input->cursor += 2;
+			vertexCount = readVarint(input, 1);
+			skipVertices(input, vertexCount);
+			input->cursor += vertexCount / 3 * 4;
+			if (nonessential) input->cursor += 4;
+			break;
+		case SP_ATTACHMENT_POINT:
+			input->cursor += 12;
+			if (nonessential) input->cursor += 4;
+			break;
+		case SP_ATTACHMENT_CLIPPING:
+			readVarint(input, 1);
+			skipVertices(input, readVarint(input, 1));
+			if (nonessential) input->cursor += 4;
+			break;
+	}
+}
+
+static void skipSkin (_dataInput* input, int/*bool*/ nonessential) {
+	int i, ii, nn;
+	for (i = 0, nn = readVarint(input, 1); i < nn; ++i) {
+		readVarint(input, 1);
+		for (ii = readVarint(input, 1); ii > 0; --ii) {
+			skipString(input);
+			skipAttachment(input, nonessential);
+		}
+	}
+}
+
+/* Skips the deform timelines of one slot. */
+static void skipDeformTimelines (_dataInput* input) {
+	int i, frameIndex, frameCount;
+	for (i = readVarint(input, 1); i > 0; --i) {
+		skipString(input);
+		frameCount = readVarint(input, 1);
+		for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+			int end;
+			input->cursor += 4;
+			end = readVarint(input, 1);
+			if (end) {
+				readVarint(input, 1);
+				input->cursor += end << 2;
+			}
+			if (frameIndex < frameCount - 1 && readByte(input) == CURVE_BEZIER) input->cursor += 16;
+		}
+	}
+}
+
+/* Returns 0 for an invalid timeline type, as the animation can't be skipped past. */
+static int/*bool*/ skipAnimation (_dataInput* input) {
+	int i, n, ii, nn, frameIndex, frameCount;
+
+	/* Slot timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
+			unsigned char timelineType = readByte(input);
+			frameCount = readVarint(input, 1);
+			switch (timelineType) {
+				case SLOT_ATTACHMENT:
+					for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+						input->cursor += 4;
+						skipString(input);
+					}
+					break;
+				case SLOT_COLOR:
+					skipFrames(input, frameCount, 8);
+					break;
+				case SLOT_TWO_COLOR:
+					skipFrames(input, frameCount, 12);
+					break;
+				default:
+					return 0;
+			}
+		}
+	}
+
+	/* Bone timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
+			unsigned char timelineType = readByte(input);
+			frameCount = readVarint(input, 1);
+			switch (timelineType) {
+				case BONE_ROTATE:
+					skipFrames(input, frameCount, 8);
+					break;
+				case BONE_TRANSLATE:
+				case BONE_SCALE:
+				case BONE_SHEAR:
+					skipFrames(input, frameCount, 12);
+					break;
+				default:
+					return 0;
+			}
+		}
+	}
+
+	/* IK constraint timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		skipFrames(input, readVarint(input, 1), 9);
+	}
+
+	/* Transform constraint timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		skipFrames(input, readVarint(input, 1), 20);
+	}
+
+	/* Path constraint timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
+			unsigned char timelineType = readByte(input);
+			frameCount = readVarint(input, 1);
+			switch (timelineType) {
+				case PATH_POSITION:
+				case PATH_SPACING:
+					skipFrames(input, frameCount, 8);
+					break;
+				case PATH_MIX:
+					skipFrames(input, frameCount, 12);
+					break;
+			}
+		}
+	}
+
+	/* Deform timelines. */
+	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
+		readVarint(input, 1);
+		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
+			readVarint(input, 1);
+			skipDeformTimelines(input);
+		}
+	}
+
+	/* Draw order timeline. */
+	for (i = readVarint(input, 1); i > 0; --i) {
+		input->cursor += 4;
+		for (ii = readVarint(input, 1); ii > 0; --ii) {
+			readVarint(input, 1);
+			readVarint(input, 1);
+		}
+	}
+
+	/* Event timeline. */
+	for (i = readVarint(input, 1); i > 0; --i) {
+		input->cursor += 4;
+		readVarint(input, 1);
+		readVarint(input, 0);
+		input->cursor += 4;
+		if (readBoolean(input)) skipString(input);
+	}
+	return 1;
+}
+
 static void _spSkeletonBinary_addLinkedMesh (spSkeletonBinary* self, spMeshAttachment* mesh,
 		const char* skin, int slotIndex, const char* parent) {
 	_spLinkedMesh* linkedMesh;
@@ -228,6 +462,8 @@ static void _spSkeletonBinary_addLinkedMesh (spSkeletonBinary* self, spMeshAttac
 
 	if (internal->linkedMeshCount == internal->linkedMeshCapacity) {
 		_spLinkedMesh* linkedMeshes;
+		/* Kept by the loader across reads, so never in the skeleton data's arena. */
+		_spArena* arena = _spSetArena(0);
 		internal->linkedMeshCapacity *= 2;
 		if (internal->linkedMeshCapacity < 8) internal->linkedMeshCapacity = 8;
 		/* TODO Why not realloc? */
@@ -235,6 +471,7 @@ static void _spSkeletonBinary_addLinkedMesh (spSkeletonBinary* self, spMeshAttac
 		memcpy(linkedMeshes, internal->linkedMeshes, sizeof(_spLinkedMesh) * internal->linkedMeshCount);
 		FREE(internal->linkedMeshes);
 		internal->linkedMeshes = linkedMeshes;
+		_spSetArena(arena);
 	}
 
 	linkedMesh = internal->linkedMeshes + internal->linkedMeshCount++;
@@ -267,10 +504,8 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 					timeline->slotIndex = slotIndex;
 					for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
 						float time = readFloat(input);
-						const char* attachmentName = readString(input);
-						/* TODO Avoid copying of attachmentName inside */
+						const char* attachmentName = readStringRef(input);
 						spAttachmentTimeline_setFrame(timeline, frameIndex, time, attachmentName);
-						FREE(attachmentName);
 					}
 					kv_push(spTimeline*, timelines, SUPER(timeline));
 					duration = MAX(duration, timeline->frames[frameCount - 1]);
@@ -469,14 +704,18 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 
 	/* Deform timelines. */
 	for (i = 0, n = readVarint(input, 1); i < n; ++i) {
-		spSkin* skin = skeletonData->skins[readVarint(input, 1)];
+		spSkin* skin = SUB_CAST(_spSkeletonBinary, self)->skins[readVarint(input, 1)];
 		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
 			int slotIndex = readVarint(input, 1);
+			if (!skin) {
+				skipDeformTimelines(input);
+				continue;
+			}
 			for (iii = 0, nnn = readVarint(input, 1); iii < nnn; ++iii) {
 				float* tempDeform;
 				spDeformTimeline *timeline;
 				int weighted, deformLength;
-				const char* attachmentName = readString(input);
+				const char* attachmentName = readStringRef(input);
 				int frameCount;
 
 				spVertexAttachment* attachment = SUB_CAST(spVertexAttachment,
@@ -487,10 +726,8 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 						spTimeline_dispose(kv_A(timelines, i));
 					kv_destroy(timelines);
 					_spSkeletonBinary_setError(self, "Attachment not found: ", attachmentName);
-					FREE(attachmentName);
 					return 0;
 				}
-				FREE(attachmentName);
 
 				weighted = attachment->bones != 0;
 				deformLength = weighted ? attachment->verticesCount / 3 * 2 : attachment->verticesCount;
@@ -606,27 +843,35 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 	return animation;
 }
 
+/* Arrays are converted from big endian in one pass straight over the input bytes. */
 static float* _readFloatArray(_dataInput *input, int n, float scale) {
 	float* array = MALLOC(float, n);
+	const unsigned char* bytes = input->cursor;
 	int i;
-	if (scale == 1)
-		for (i = 0; i < n; ++i)
-			array[i] = readFloat(input);
-	else
+	for (i = 0; i < n; ++i, bytes += 4) {
+		union {
+			unsigned int intValue;
+			float floatValue;
+		} intToFloat;
+		intToFloat.intValue = ((unsigned int)bytes[0] << 24) | ((unsigned int)bytes[1] << 16) | ((unsigned int)bytes[2] << 8) | bytes[3];
+		array[i] = intToFloat.floatValue;
+	}
+	input->cursor = bytes;
+	if (scale != 1)
 		for (i = 0; i < n; ++i)
-			array[i] = readFloat(input) * scale;
+			array[i] *= scale;
 	return array;
 }
 
 static short* _readShortArray(_dataInput *input, int *length) {
 	int n = readVarint(input, 1);
 	short* array = MALLOC(short, n);
+	const unsigned char* bytes = input->cursor;
 	int i;
 	*length = n;
-	for (i = 0; i < n; ++i) {
-		array[i] = readByte(input) << 8;
-		array[i] |= readByte(input);
-	}
+	for (i = 0; i < n; ++i, bytes += 2)
+		array[i] = (short)((bytes[0] << 8) | bytes[1]);
+	input->cursor = bytes;
 	return array;
 }
 
@@ -675,14 +920,9 @@ static void _readVertices(spSkeletonBinary* self, _dataInput* input, spVertexAtt
 
 spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput* input,
 		spSkin* skin, int slotIndex, const char* attachmentName, spSkeletonData* skeletonData, int/*bool*/ nonessential) {
-	int i;
 	spAttachmentType type;
-	const char* name = readString(input);
-	int freeName = name != 0;
-	if (!name) {
-		freeName = 0;
-		name = attachmentName;
-	}
+	const char* name = readStringRef(input);
+	if (!name) name = attachmentName;
 
 	type = (spAttachmentType)readByte(input);
 
@@ -705,7 +945,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			readColor(input, &region->color.r, &region->color.g, &region->color.b, &region->color.a);
 			spRegionAttachment_updateOffset(region);
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_BOUNDING_BOX: {
@@ -714,7 +953,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			_readVertices(self, input, SUB_CAST(spVertexAttachment, attachment), vertexCount);
 			if (nonessential) readInt(input); /* Skip color. */
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_MESH: {
@@ -743,7 +981,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 				mesh->height = 0;
 			}
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_LINKED_MESH: {
@@ -757,15 +994,14 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			mesh = SUB_CAST(spMeshAttachment, attachment);
 			mesh->path = path;
 			readColor(input, &mesh->color.r, &mesh->color.g, &mesh->color.b, &mesh->color.a);
-			skinName = readString(input);
-			parent = readString(input);
+			skinName = readStringRef(input);
+			parent = readStringRef(input);
 			mesh->inheritDeform = readBoolean(input);
 			if (nonessential) {
 				mesh->width = readFloat(input) * self->scale;
 				mesh->height = readFloat(input) * self->scale;
 			}
 			_spSkeletonBinary_addLinkedMesh(self, mesh, skinName, slotIndex, parent);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_PATH: {
@@ -777,12 +1013,8 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			vertexCount = readVarint(input, 1);
 			_readVertices(self, input, SUPER(path), vertexCount);
 			path->lengthsLength = vertexCount / 3;
-			path->lengths = MALLOC(float, path->lengthsLength);
-			for (i = 0; i < path->lengthsLength; ++i) {
-				path->lengths[i] = readFloat(input) * self->scale;
-			}
+			path->lengths = _readFloatArray(input, path->lengthsLength, self->scale);
 			if (nonessential) readInt(input); /* Skip color. */
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_POINT: {
@@ -806,12 +1038,10 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			if (nonessential) readInt(input); /* Skip color. */
 			clip->endSlot = skeletonData->slots[endSlotIndex];
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 	}
 
-	if (freeName) FREE(name);
 	return 0;
 }
 
@@ -826,10 +1056,9 @@ spSkin* spSkeletonBinary_readSkin(spSkeletonBinary* self, _dataInput* input,
 	for (i = 0; i < slotCount; ++i) {
 		int slotIndex = readVarint(input, 1);
 		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
-			const char* name = readString(input);
+			const char* name = readStringRef(input);
 			spAttachment* attachment = spSkeletonBinary_readAttachment(self, input, skin, slotIndex, name, skeletonData, nonessential);
 			if (attachment) spSkin_addAttachment(skin, slotIndex, name, attachment);
-			FREE(name);
 		}
 	}
 	return skin;
@@ -843,14 +1072,30 @@ spSkeletonData* spSkeletonBinary_readSkeletonDataFile (spSkeletonBinary* self, c
 		_spSkeletonBinary_setError(self, "Unable to read skeleton file: ", path);
 		return 0;
 	}
-	skeletonData = spSkeletonBinary_readSkeletonData(self, (unsigned char*)binary, length);
+	skeletonData = spSkeletonBinary_readSkeletonDataInPlace(self, (unsigned char*)binary, length);
 	FREE(binary);
 	return skeletonData;
 }
 
 spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const unsigned char* binary,
 		const int length) {
-	int i, ii, nonessential;
+	spSkeletonData* skeletonData;
+	unsigned char* copy = MALLOC(unsigned char, length);
+	memcpy(copy, binary, length);
+	skeletonData = spSkeletonBinary_readSkeletonDataInPlace(self, copy, length);
+	FREE(copy);
+	return skeletonData;
+}
+
+static void _spSkeletonBinary_freeSkins (spSkeletonBinary* self, spSkeletonData* skeletonData) {
+	_spSkeletonBinary* internal = SUB_CAST(_spSkeletonBinary, self);
+	if (internal->skins != skeletonData->skins) FREE(internal->skins);
+	internal->skins = 0;
+}
+
+static spSkeletonData* _spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, unsigned char* binary,
+		const int length) {
+	int i, ii, nonessential, skinsCount, animationsCount;
 	spSkeletonData* skeletonData;
 	_spSkeletonBinary* internal = SUB_CAST(_spSkeletonBinary, self);
 
@@ -884,7 +1129,7 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	if (nonessential) {
 		/* Skip images path & fps */
 		readFloat(input);
-		FREE(readString(input));
+		readStringRef(input);
 	}
 
 	/* Bones. */
@@ -893,11 +1138,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	for (i = 0; i < skeletonData->bonesCount; ++i) {
 		spBoneData* data;
 		int mode;
-		const char* name = readString(input);
+		const char* name = readStringRef(input);
 		spBoneData* parent = i == 0 ? 0 : skeletonData->bones[readVarint(input, 1)];
-		/* TODO Avoid copying of name */
 		data = spBoneData_create(i, name, parent);
-		FREE(name);
 		data->rotation = readFloat(input);
 		data->x = readFloat(input) * self->scale;
 		data->y = readFloat(input) * self->scale;
@@ -923,12 +1166,10 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->slots = MALLOC(spSlotData*, skeletonData->slotsCount);
 	for (i = 0; i < skeletonData->slotsCount; ++i) {
 		int r, g, b, a;
-		const char* slotName = readString(input);
+		const char* slotName = readStringRef(input);
 		spBoneData* boneData = skeletonData->bones[readVarint(input, 1)];
-		/* TODO Avoid copying of slotName */
 		spSlotData* slotData = spSlotData_create(i, slotName, boneData);
-		FREE(slotName);
-		readColor(input, &slotData->color.r, &slotData->color.g, &slotData->color.b, &slotData->color.a);
+		readColor(input, &slotData->color.r, &slotData->color.g, &slotData->color.b, &slotData->color.a);
 		a = readByte(input);
 		r = readByte(input);
 		g = readByte(input);
@@ -946,11 +1187,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->ikConstraintsCount = readVarint(input, 1);
 	skeletonData->ikConstraints = MALLOC(spIkConstraintData*, skeletonData->ikConstraintsCount);
 	for (i = 0; i < skeletonData->ikConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readStringRef(input);
 		spIkConstraintData* data = spIkConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		data->bones = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -966,11 +1205,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->transformConstraints = MALLOC(
 			spTransformConstraintData*, skeletonData->transformConstraintsCount);
 	for (i = 0; i < skeletonData->transformConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readStringRef(input);
 		spTransformConstraintData* data = spTransformConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		CONST_CAST(spBoneData**, data->bones) = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -995,11 +1232,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->pathConstraintsCount = readVarint(input, 1);
 	skeletonData->pathConstraints = MALLOC(spPathConstraintData*, skeletonData->pathConstraintsCount);
 	for (i = 0; i < skeletonData->pathConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readStringRef(input);
 		spPathConstraintData* data = spPathConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		CONST_CAST(spBoneData**, data->bones) = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -1020,22 +1255,27 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 
 	/* Default skin. */
 	skeletonData->defaultSkin = spSkeletonBinary_readSkin(self, input, "default", skeletonData, nonessential);
-	skeletonData->skinsCount = readVarint(input, 1);
+	skinsCount = readVarint(input, 1);
 
 	if (skeletonData->defaultSkin)
-		++skeletonData->skinsCount;
+		++skinsCount;
 
-	skeletonData->skins = MALLOC(spSkin*, skeletonData->skinsCount);
+	skeletonData->skins = MALLOC(spSkin*, skinsCount);
+	internal->skins = self->skinNames ? MALLOC(spSkin*, skinsCount) : skeletonData->skins;
 
 	if (skeletonData->defaultSkin)
-		skeletonData->skins[0] = skeletonData->defaultSkin;
+		skeletonData->skins[skeletonData->skinsCount++] = internal->skins[0] = skeletonData->defaultSkin;
 
 	/* Skins. */
-	for (i = skeletonData->defaultSkin ? 1 : 0; i < skeletonData->skinsCount; ++i) {
-		const char* skinName = readString(input);
-		/* TODO Avoid copying of skinName */
-		skeletonData->skins[i] = spSkeletonBinary_readSkin(self, input, skinName, skeletonData, nonessential);
-		FREE(skinName);
+	for (i = skeletonData->defaultSkin ? 1 : 0; i < skinsCount; ++i) {
+		const char* skinName = readStringRef(input);
+		if (!_spContainsName(self->skinNames, self->skinNamesCount, skinName)) {
+			skipSkin(input, nonessential);
+			internal->skins[i] = 0;
+			continue;
+		}
+		skeletonData->skins[skeletonData->skinsCount++] = internal->skins[i] =
+				spSkeletonBinary_readSkin(self, input, skinName, skeletonData, nonessential);
 	}
 
 	/* Linked meshes. */
@@ -1045,6 +1285,7 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 		spAttachment* parent;
 		if (!skin) {
 			FREE(input);
+			_spSkeletonBinary_freeSkins(self, skeletonData);
 			spSkeletonData_dispose(skeletonData);
 			_spSkeletonBinary_setError(self, "Skin not found: ", linkedMesh->skin);
 			return 0;
@@ -1052,6 +1293,7 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 		parent = spSkin_getAttachment(skin, linkedMesh->slotIndex, linkedMesh->parent);
 		if (!parent) {
 			FREE(input);
+			_spSkeletonBinary_freeSkins(self, skeletonData);
 			spSkeletonData_dispose(skeletonData);
 			_spSkeletonBinary_setError(self, "Parent mesh not found: ", linkedMesh->parent);
 			return 0;
@@ -1065,31 +1307,59 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->eventsCount = readVarint(input, 1);
 	skeletonData->events = MALLOC(spEventData*, skeletonData->eventsCount);
 	for (i = 0; i < skeletonData->eventsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of skinName */
+		const char* name = readStringRef(input);
 		spEventData* eventData = spEventData_create(name);
-		FREE(name);
 		eventData->intValue = readVarint(input, 0);
 		eventData->floatValue = readFloat(input);
 		eventData->stringValue = readString(input);
 		skeletonData->events[i] = eventData;
 	}
 
+	/* Index what animations look up by name, then again once the animations are added. */
+	_spSkeletonData_updateIndex(skeletonData);
+
 	/* Animations. */
-	skeletonData->animationsCount = readVarint(input, 1);
-	skeletonData->animations = MALLOC(spAnimation*, skeletonData->animationsCount);
-	for (i = 0; i < skeletonData->animationsCount; ++i) {
-		const char* name = readString(input);
-		spAnimation* animation = _spSkeletonBinary_readAnimation(self, name, input, skeletonData);
-		FREE(name);
+	animationsCount = readVarint(input, 1);
+	skeletonData->animations = MALLOC(spAnimation*, animationsCount);
+	for (i = 0; i < animationsCount; ++i) {
+		const char* name = readStringRef(input);
+		spAnimation* animation;
+		if (!_spContainsName(self->animationNames, self->animationNamesCount, name)) {
+			if (skipAnimation(input)) continue;
+			FREE(input);
+			_spSkeletonBinary_freeSkins(self, skeletonData);
+			spSkeletonData_dispose(skeletonData);
+			_spSkeletonBinary_setError(self, "Invalid timeline type in animation: ", name);
+			return 0;
+		}
+		animation = _spSkeletonBinary_readAnimation(self, name, input, skeletonData);
 		if (!animation) {
 			FREE(input);
+			_spSkeletonBinary_freeSkins(self, skeletonData);
 			spSkeletonData_dispose(skeletonData);
 			return 0;
 		}
-		skeletonData->animations[i] = animation;
+		skeletonData->animations[skeletonData->animationsCount++] = animation;
 	}
+	_spSkeletonData_updateIndex(skeletonData);
 
 	FREE(input);
+	_spSkeletonBinary_freeSkins(self, skeletonData);
+	return skeletonData;
+}
+
+spSkeletonData* spSkeletonBinary_readSkeletonDataInPlace (spSkeletonBinary* self, unsigned char* binary,
+		const int length) {
+	spSkeletonData* skeletonData;
+	_spArena* arena = self->useArena ? _spArena_create(length) : 0;
+	_spArena* previous = _spSetArena(arena);
+	skeletonData = _spSkeletonBinary_readSkeletonData(self, binary, length);
+	_spSetArena(previous);
+	if (arena) {
+		if (skeletonData)
+			_spSkeletonData_setArena(skeletonData, arena);
+		else
+			_spArena_dispose(arena);
+	}
 	return skeletonData;
 }
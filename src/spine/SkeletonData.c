@@ -30,14 +30,52 @@
 
 #include <spine/SkeletonData.h>
 #include <string.h>
+#include <stddef.h>
 #include <spine/extension.h>
 
+typedef struct _spSkeletonData {
+	spSkeletonData super;
+	int/*bool*/ indexed;
+	_spNameTable bones;
+	_spNameTable slots;
+	_spNameTable skins;
+	_spNameTable events;
+	_spNameTable animations;
+	_spNameTable ikConstraints;
+	_spNameTable transformConstraints;
+	_spNameTable pathConstraints;
+	_spArena* arena;
+} _spSkeletonData;
+
 spSkeletonData* spSkeletonData_create () {
-	return NEW(spSkeletonData);
+	return SUPER(NEW(_spSkeletonData));
+}
+
+static void _spSkeletonData_disposeIndex (_spSkeletonData* internal) {
+	_spNameTable_deinit(&internal->bones);
+	_spNameTable_deinit(&internal->slots);
+	_spNameTable_deinit(&internal->skins);
+	_spNameTable_deinit(&internal->events);
+	_spNameTable_deinit(&internal->animations);
+	_spNameTable_deinit(&internal->ikConstraints);
+	_spNameTable_deinit(&internal->transformConstraints);
+	_spNameTable_deinit(&internal->pathConstraints);
 }
 
 void spSkeletonData_dispose (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
 	int i;
+	if (internal->arena) {
+		/* Everything read by the loader is in the arena. The index may have been rebuilt since, with the arena current
+		 * only the tables that are not in it are freed. */
+		_spArena* arena = internal->arena;
+		_spArena* previous = _spSetArena(arena);
+		_spSkeletonData_disposeIndex(internal);
+		_spSetArena(previous);
+		_spArena_dispose(arena);
+		return;
+	}
+
 	for (i = 0; i < self->bonesCount; ++i)
 		spBoneData_dispose(self->bones[i]);
 	FREE(self->bones);
@@ -73,75 +111,125 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 	FREE(self->hash);
 	FREE(self->version);
 
+	_spSkeletonData_disposeIndex(internal);
+
 	FREE(self);
 }
 
-spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName) {
+void _spSkeletonData_setArena (spSkeletonData* self, _spArena* arena) {
+	SUB_CAST(_spSkeletonData, self)->arena = arena;
+}
+
+_spArena* _spSkeletonData_getArena (const spSkeletonData* self) {
+	return SUB_CAST(_spSkeletonData, self)->arena;
+}
+
+static const char** _spSkeletonData_names (void** items, int count, size_t nameOffset) {
 	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->bones[i]->name, boneName) == 0) return self->bones[i];
-	return 0;
+	const char** names = MALLOC(const char*, count > 0 ? count : 1);
+	for (i = 0; i < count; ++i)
+		names[i] = *(const char**)((const char*)items[i] + nameOffset);
+	return names;
+}
+
+#define INDEX_NAMES(TABLE, ITEMS, COUNT, TYPE) \
+	_spNameTable_deinit(&internal->TABLE); \
+	_spNameTable_init(&internal->TABLE, _spSkeletonData_names((void**)self->ITEMS, self->COUNT, offsetof(TYPE, name)), self->COUNT)
+
+void _spSkeletonData_updateIndex (spSkeletonData* self) {
+	_spSkeletonData* internal = SUB_CAST(_spSkeletonData, self);
+	INDEX_NAMES(bones, bones, bonesCount, spBoneData);
+	INDEX_NAMES(slots, slots, slotsCount, spSlotData);
+	INDEX_NAMES(skins, skins, skinsCount, spSkin);
+	INDEX_NAMES(events, events, eventsCount, spEventData);
+	INDEX_NAMES(animations, animations, animationsCount, spAnimation);
+	INDEX_NAMES(ikConstraints, ikConstraints, ikConstraintsCount, spIkConstraintData);
+	INDEX_NAMES(transformConstraints, transformConstraints, transformConstraintsCount, spTransformConstraintData);
+	INDEX_NAMES(pathConstraints, pathConstraints, pathConstraintsCount, spPathConstraintData);
+	internal->indexed = 1;
+}
+
+#undef INDEX_NAMES
+
+/* Data built by hand rather than loaded has no index until _spSkeletonData_updateIndex is called, so fall back to a scan. */
+#define FIND_INDEX(TABLE, ITEMS, COUNT, NAME) \
+	const _spSkeletonData* internal = SUB_CAST(_spSkeletonData, self); \
+	int i; \
+	if (internal->indexed) return _spNameTable_find(&internal->TABLE, NAME); \
+	for (i = 0; i < self->COUNT; ++i) \
+		if (strcmp(self->ITEMS[i]->name, NAME) == 0) return i; \
+	return -1
+
+spBoneData* spSkeletonData_findBone (const spSkeletonData* self, const char* boneName) {
+	int index = spSkeletonData_findBoneIndex(self, boneName);
+	return index == -1 ? 0 : self->bones[index];
 }
 
 int spSkeletonData_findBoneIndex (const spSkeletonData* self, const char* boneName) {
-	int i;
-	for (i = 0; i < self->bonesCount; ++i)
-		if (strcmp(self->bones[i]->name, boneName) == 0) return i;
-	return -1;
+	FIND_INDEX(bones, bones, bonesCount, boneName);
 }
 
 spSlotData* spSkeletonData_findSlot (const spSkeletonData* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->slots[i]->name, slotName) == 0) return self->slots[i];
-	return 0;
+	int index = spSkeletonData_findSlotIndex(self, slotName);
+	return index == -1 ? 0 : self->slots[index];
 }
 
 int spSkeletonData_findSlotIndex (const spSkeletonData* self, const char* slotName) {
-	int i;
-	for (i = 0; i < self->slotsCount; ++i)
-		if (strcmp(self->slots[i]->name, slotName) == 0) return i;
-	return -1;
+	FIND_INDEX(slots, slots, slotsCount, slotName);
+}
+
+static int _spSkeletonData_findSkinIndex (const spSkeletonData* self, const char* skinName) {
+	FIND_INDEX(skins, skins, skinsCount, skinName);
 }
 
 spSkin* spSkeletonData_findSkin (const spSkeletonData* self, const char* skinName) {
-	int i;
-	for (i = 0; i < self->skinsCount; ++i)
-		if (strcmp(self->skins[i]->name, skinName) == 0) return self->skins[i];
-	return 0;
+	int index = _spSkeletonData_findSkinIndex(self, skinName);
+	return index == -1 ? 0 : self->skins[index];
+}
+
+static int _spSkeletonData_findEventIndex (const spSkeletonData* self, const char* eventName) {
+	FIND_INDEX(events, events, eventsCount, eventName);
 }
 
 spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* eventName) {
-	int i;
-	for (i = 0; i < self->eventsCount; ++i)
-		if (strcmp(self->events[i]->name, eventName) == 0) return self->events[i];
-	return 0;
+	int index = _spSkeletonData_findEventIndex(self, eventName);
+	return index == -1 ? 0 : self->events[index];
+}
+
+int spSkeletonData_findAnimationIndex (const spSkeletonData* self, const char* animationName) {
+	FIND_INDEX(animations, animations, animationsCount, animationName);
 }
 
 spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName) {
-	int i;
-	for (i = 0; i < self->animationsCount; ++i)
-		if (strcmp(self->animations[i]->name, animationName) == 0) return self->animations[i];
-	return 0;
+	int index = spSkeletonData_findAnimationIndex(self, animationName);
+	return index == -1 ? 0 : self->animations[index];
+}
+
+int spSkeletonData_findIkConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	FIND_INDEX(ikConstraints, ikConstraints, ikConstraintsCount, constraintName);
 }
 
 spIkConstraintData* spSkeletonData_findIkConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->ikConstraintsCount; ++i)
-		if (strcmp(self->ikConstraints[i]->name, constraintName) == 0) return self->ikConstraints[i];
-	return 0;
+	int index = spSkeletonData_findIkConstraintIndex(self, constraintName);
+	return index == -1 ? 0 : self->ikConstraints[index];
+}
+
+int spSkeletonData_findTransformConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	FIND_INDEX(transformConstraints, transformConstraints, transformConstraintsCount, constraintName);
 }
 
 spTransformConstraintData* spSkeletonData_findTransformConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->transformConstraintsCount; ++i)
-		if (strcmp(self->transformConstraints[i]->name, constraintName) == 0) return self->transformConstraints[i];
-	return 0;
+	int index = spSkeletonData_findTransformConstraintIndex(self, constraintName);
+	return index == -1 ? 0 : self->transformConstraints[index];
+}
+
+int spSkeletonData_findPathConstraintIndex (const spSkeletonData* self, const char* constraintName) {
+	FIND_INDEX(pathConstraints, pathConstraints, pathConstraintsCount, constraintName);
 }
 
 spPathConstraintData* spSkeletonData_findPathConstraint (const spSkeletonData* self, const char* constraintName) {
-	int i;
-	for (i = 0; i < self->pathConstraintsCount; ++i)
-		if (strcmp(self->pathConstraints[i]->name, constraintName) == 0) return self->pathConstraints[i];
-	return 0;
+	int index = spSkeletonData_findPathConstraintIndex(self, constraintName);
+	return index == -1 ? 0 : self->pathConstraints[index];
 }
+
+#undef FIND_INDEX
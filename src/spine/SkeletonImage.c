@@ -0,0 +1,544 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonImage.h>
+#include <spine/extension.h>
+#include <spine/Animation.h>
+#include "kvec.h"
+
+#define IMAGE_VERSION 1
+
+typedef struct {
+	char magic[4];
+	int version;
+	int layout;
+	int size; /* Bytes of data following the header, a copy of the arena with the pointers replaced by offsets. */
+	int root; /* Offset of the skeleton data. */
+	/* Offsets of the pointers to relocate, then of the attachments and the timelines, follow the data. */
+	int pointersCount;
+	int attachmentsCount;
+	int timelinesCount;
+} _spImageHeader;
+
+typedef struct {
+	const _spArena* arena;
+	char* data;
+	int/*bool*/ outside;
+	kvec_t(int) pointers;
+	kvec_t(int) attachments;
+	kvec_t(int) timelines;
+} _spImageWriter;
+
+spSkeletonImage* spSkeletonImage_create (spAtlas* atlas) {
+	spSkeletonImage* self = NEW(spSkeletonImage);
+	self->atlas = atlas;
+	return self;
+}
+
+void spSkeletonImage_dispose (spSkeletonImage* self) {
+	FREE(self->error);
+	FREE(self);
+}
+
+void _spSkeletonImage_setError (spSkeletonImage* self, const char* value1, const char* value2) {
+	char message[256];
+	int length;
+	_spArena* arena = _spSetArena(0);
+	FREE(self->error);
+	strcpy(message, value1);
+	length = (int)strlen(value1);
+	if (value2) strncat(message + length, value2, 255 - length);
+	MALLOC_STR(self->error, message);
+	_spSetArena(arena);
+}
+
+/* Changes with the pointer size, the byte order and the size of the structs an image holds. */
+static int _spSkeletonImage_layout () {
+	static const int one = 1;
+	unsigned int layout = (unsigned int)sizeof(void*) * 2 + *(const char*)&one;
+#define LAYOUT(TYPE) layout = layout * 31 + (unsigned int)sizeof(TYPE)
+	LAYOUT(size_t);
+	LAYOUT(spSkeletonData);
+	LAYOUT(spBoneData);
+	LAYOUT(spSlotData);
+	LAYOUT(_spSkin);
+	LAYOUT(_Entry);
+	LAYOUT(_SkinHashTableEntry);
+	LAYOUT(spEventData);
+	LAYOUT(spEvent);
+	LAYOUT(spIkConstraintData);
+	LAYOUT(spTransformConstraintData);
+	LAYOUT(spPathConstraintData);
+	LAYOUT(spAnimation);
+	LAYOUT(spBaseTimeline);
+	LAYOUT(spAttachmentTimeline);
+	LAYOUT(spEventTimeline);
+	LAYOUT(spDrawOrderTimeline);
+	LAYOUT(spDeformTimeline);
+	LAYOUT(spRegionAttachment);
+	LAYOUT(spBoundingBoxAttachment);
+	LAYOUT(spMeshAttachment);
+	LAYOUT(spPathAttachment);
+	LAYOUT(spPointAttachment);
+	LAYOUT(spClippingAttachment);
+#undef LAYOUT
+	return (int)layout;
+}
+
+/**/
+
+/* Replaces the pointer at address in the copy with the offset of its target and records it for relocation. */
+static void _writePointer (_spImageWriter* writer, const void* address) {
+	const void* target = *(const void* const*)address;
+	int offset, targetOffset;
+	size_t value;
+	if (!target) return;
+	offset = _spArena_getUsedOffset(writer->arena, address);
+	targetOffset = _spArena_getUsedOffset(writer->arena, target);
+	if (offset == -1 || targetOffset == -1) {
+		writer->outside = 1;
+		return;
+	}
+	value = (size_t)targetOffset;
+	memcpy(writer->data + offset, &value, sizeof(value));
+	kv_push(int, writer->pointers, offset);
+}
+
+/* The pointer at address and the count pointers of the array it points to. */
+static void _writePointers (_spImageWriter* writer, const void* address, int count) {
+	void* const* pointers = *(void* const* const*)address;
+	int i;
+	_writePointer(writer, address);
+	if (!pointers) return;
+	for (i = 0; i < count; ++i)
+		_writePointer(writer, &pointers[i]);
+}
+
+/* Pointers outside the image, set again when it is read. */
+static void _clearPointer (_spImageWriter* writer, const void* address) {
+	int offset = _spArena_getUsedOffset(writer->arena, address);
+	if (offset == -1) {
+		writer->outside = 1;
+		return;
+	}
+	memset(writer->data + offset, 0, sizeof(void*));
+}
+
+static int _writeObject (_spImageWriter* writer, const void* object) {
+	int offset = _spArena_getUsedOffset(writer->arena, object);
+	if (offset == -1) writer->outside = 1;
+	return offset;
+}
+
+static void _writeVertexAttachment (_spImageWriter* writer, spVertexAttachment* attachment) {
+	_writePointer(writer, &attachment->bones);
+	_writePointer(writer, &attachment->vertices);
+}
+
+static void _writeAttachment (_spImageWriter* writer, spAttachment* attachment) {
+	kv_push(int, writer->attachments, _writeObject(writer, attachment));
+	_writePointer(writer, &attachment->name);
+	_clearPointer(writer, &attachment->vtable);
+	_writePointer(writer, &attachment->attachmentLoader);
+
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		spRegionAttachment* region = SUB_CAST(spRegionAttachment, attachment);
+		_writePointer(writer, &region->path);
+		_clearPointer(writer, &region->rendererObject);
+		break;
+	}
+	case SP_ATTACHMENT_MESH:
+	case SP_ATTACHMENT_LINKED_MESH: {
+		spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, attachment);
+		_writeVertexAttachment(writer, SUPER(mesh));
+		_clearPointer(writer, &mesh->rendererObject);
+		_writePointer(writer, &mesh->path);
+		_writePointer(writer, &mesh->regionUVs);
+		_writePointer(writer, &mesh->uvs);
+		_writePointer(writer, &mesh->triangles);
+		_writePointer(writer, &mesh->parentMesh);
+		_writePointer(writer, &mesh->edges);
+		break;
+	}
+	case SP_ATTACHMENT_PATH: {
+		spPathAttachment* path = SUB_CAST(spPathAttachment, attachment);
+		_writeVertexAttachment(writer, SUPER(path));
+		_writePointer(writer, &path->lengths);
+		break;
+	}
+	case SP_ATTACHMENT_CLIPPING: {
+		spClippingAttachment* clipping = SUB_CAST(spClippingAttachment, attachment);
+		_writeVertexAttachment(writer, SUPER(clipping));
+		_writePointer(writer, &clipping->endSlot);
+		break;
+	}
+	case SP_ATTACHMENT_BOUNDING_BOX:
+	case SP_ATTACHMENT_POINT:
+		_writeVertexAttachment(writer, SUB_CAST(spVertexAttachment, attachment));
+		break;
+	}
+}
+
+static void _writeSkin (_spImageWriter* writer, spSkin* skin) {
+	_spSkin* internal = SUB_CAST(_spSkin, skin);
+	_Entry* entry;
+	int i;
+	_writePointer(writer, &skin->name);
+	_writePointer(writer, &internal->entries);
+	for (entry = internal->entries; entry; entry = entry->next) {
+		_writePointer(writer, &entry->name);
+		_writePointer(writer, &entry->attachment);
+		_writePointer(writer, &entry->next);
+		_writeAttachment(writer, entry->attachment);
+	}
+	for (i = 0; i < SKIN_ENTRIES_HASH_TABLE_SIZE; ++i) {
+		_SkinHashTableEntry* hashEntry;
+		_writePointer(writer, &internal->entriesHashTable[i]);
+		for (hashEntry = internal->entriesHashTable[i]; hashEntry; hashEntry = hashEntry->next) {
+			_writePointer(writer, &hashEntry->entry);
+			_writePointer(writer, &hashEntry->next);
+		}
+	}
+}
+
+static void _writeTimeline (_spImageWriter* writer, spTimeline* timeline) {
+	int i;
+	kv_push(int, writer->timelines, _writeObject(writer, timeline));
+	_clearPointer(writer, &timeline->vtable);
+
+	switch (timeline->type) {
+	case SP_TIMELINE_ATTACHMENT: {
+		spAttachmentTimeline* self = SUB_CAST(spAttachmentTimeline, timeline);
+		_writePointer(writer, &self->frames);
+		_writePointers(writer, &self->attachmentNames, self->framesCount);
+		break;
+	}
+	case SP_TIMELINE_EVENT: {
+		spEventTimeline* self = SUB_CAST(spEventTimeline, timeline);
+		_writePointer(writer, &self->frames);
+		_writePointer(writer, &self->events);
+		for (i = 0; i < self->framesCount; ++i) {
+			_writePointer(writer, &self->events[i]);
+			_writePointer(writer, &self->events[i]->data);
+			_writePointer(writer, &self->events[i]->stringValue);
+		}
+		break;
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		spDrawOrderTimeline* self = SUB_CAST(spDrawOrderTimeline, timeline);
+		_writePointer(writer, &self->frames);
+		_writePointers(writer, &self->drawOrders, self->framesCount);
+		break;
+	}
+	case SP_TIMELINE_DEFORM: {
+		spDeformTimeline* self = SUB_CAST(spDeformTimeline, timeline);
+		_writePointer(writer, &SUPER(self)->curves);
+		_writePointer(writer, &self->frames);
+		_writePointers(writer, &self->frameVertices, self->framesCount);
+		_writePointer(writer, &self->attachment);
+		break;
+	}
+	default: {
+		/* The other timelines are all laid out as spBaseTimeline. */
+		spBaseTimeline* self = SUB_CAST(spBaseTimeline, timeline);
+		_writePointer(writer, &SUPER(self)->curves);
+		_writePointer(writer, &self->frames);
+	}
+	}
+}
+
+static void _writeSkeletonData (_spImageWriter* writer, spSkeletonData* skeletonData) {
+	int i, ii;
+	_writePointer(writer, &skeletonData->version);
+	_writePointer(writer, &skeletonData->hash);
+
+	_writePointers(writer, &skeletonData->bones, skeletonData->bonesCount);
+	for (i = 0; i < skeletonData->bonesCount; ++i) {
+		spBoneData* bone = skeletonData->bones[i];
+		_writePointer(writer, &bone->name);
+		_writePointer(writer, &bone->parent);
+	}
+
+	_writePointers(writer, &skeletonData->slots, skeletonData->slotsCount);
+	for (i = 0; i < skeletonData->slotsCount; ++i) {
+		spSlotData* slot = skeletonData->slots[i];
+		_writePointer(writer, &slot->name);
+		_writePointer(writer, &slot->boneData);
+		_writePointer(writer, &slot->attachmentName);
+		_writePointer(writer, &slot->darkColor);
+	}
+
+	_writePointers(writer, &skeletonData->skins, skeletonData->skinsCount);
+	for (i = 0; i < skeletonData->skinsCount; ++i)
+		_writeSkin(writer, skeletonData->skins[i]);
+	_writePointer(writer, &skeletonData->defaultSkin);
+
+	_writePointers(writer, &skeletonData->events, skeletonData->eventsCount);
+	for (i = 0; i < skeletonData->eventsCount; ++i) {
+		spEventData* event = skeletonData->events[i];
+		_writePointer(writer, &event->name);
+		_writePointer(writer, &event->stringValue);
+	}
+
+	_writePointers(writer, &skeletonData->animations, skeletonData->animationsCount);
+	for (i = 0; i < skeletonData->animationsCount; ++i) {
+		spAnimation* animation = skeletonData->animations[i];
+		_writePointer(writer, &animation->name);
+		_writePointers(writer, &animation->timelines, animation->timelinesCount);
+		for (ii = 0; ii < animation->timelinesCount; ++ii)
+			_writeTimeline(writer, animation->timelines[ii]);
+	}
+
+	_writePointers(writer, &skeletonData->ikConstraints, skeletonData->ikConstraintsCount);
+	for (i = 0; i < skeletonData->ikConstraintsCount; ++i) {
+		spIkConstraintData* constraint = skeletonData->ikConstraints[i];
+		_writePointer(writer, &constraint->name);
+		_writePointers(writer, &constraint->bones, constraint->bonesCount);
+		_writePointer(writer, &constraint->target);
+	}
+
+	_writePointers(writer, &skeletonData->transformConstraints, skeletonData->transformConstraintsCount);
+	for (i = 0; i < skeletonData->transformConstraintsCount; ++i) {
+		spTransformConstraintData* constraint = skeletonData->transformConstraints[i];
+		_writePointer(writer, &constraint->name);
+		_writePointers(writer, &constraint->bones, constraint->bonesCount);
+		_writePointer(writer, &constraint->target);
+	}
+
+	_writePointers(writer, &skeletonData->pathConstraints, skeletonData->pathConstraintsCount);
+	for (i = 0; i < skeletonData->pathConstraintsCount; ++i) {
+		spPathConstraintData* constraint = skeletonData->pathConstraints[i];
+		_writePointer(writer, &constraint->name);
+		_writePointers(writer, &constraint->bones, constraint->bonesCount);
+		_writePointer(writer, &constraint->target);
+	}
+}
+
+unsigned char* spSkeletonImage_writeSkeletonData (spSkeletonImage* self, const spSkeletonData* skeletonData, int* length) {
+	_spImageWriter writer;
+	_spImageHeader header;
+	unsigned char* image;
+	unsigned char* cursor;
+	size_t size;
+
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = 0;
+
+	writer.arena = _spSkeletonData_getArena(skeletonData);
+	if (!writer.arena) {
+		_spSkeletonImage_setError(self, "Skeleton data was not read into an arena.", 0);
+		return 0;
+	}
+	size = _spArena_getUsedSize(writer.arena);
+	writer.data = MALLOC(char, size);
+	_spArena_copyUsed(writer.arena, writer.data);
+	writer.outside = 0;
+	kv_init(writer.pointers);
+	kv_init(writer.attachments);
+	kv_init(writer.timelines);
+
+	memcpy(header.magic, "SPIM", 4);
+	header.version = IMAGE_VERSION;
+	header.layout = _spSkeletonImage_layout();
+	header.size = (int)size;
+	header.root = _writeObject(&writer, skeletonData);
+	_writeSkeletonData(&writer, CONST_CAST(spSkeletonData*, skeletonData));
+	header.pointersCount = (int)kv_size(writer.pointers);
+	header.attachmentsCount = (int)kv_size(writer.attachments);
+	header.timelinesCount = (int)kv_size(writer.timelines);
+
+	if (writer.outside) {
+		_spSkeletonImage_setError(self, "Skeleton data has memory outside of its arena.", 0);
+		image = 0;
+	} else {
+		*length = (int)(sizeof(header) + size + sizeof(int) * (kv_size(writer.pointers) + kv_size(writer.attachments)
+				+ kv_size(writer.timelines)));
+		image = MALLOC(unsigned char, *length);
+		cursor = image;
+		memcpy(cursor, &header, sizeof(header));
+		cursor += sizeof(header);
+		memcpy(cursor, writer.data, size);
+		cursor += size;
+		memcpy(cursor, kv_array(writer.pointers), sizeof(int) * kv_size(writer.pointers));
+		cursor += sizeof(int) * kv_size(writer.pointers);
+		memcpy(cursor, kv_array(writer.attachments), sizeof(int) * kv_size(writer.attachments));
+		cursor += sizeof(int) * kv_size(writer.attachments);
+		memcpy(cursor, kv_array(writer.timelines), sizeof(int) * kv_size(writer.timelines));
+	}
+
+	kv_destroy(writer.pointers);
+	kv_destroy(writer.attachments);
+	kv_destroy(writer.timelines);
+	FREE(writer.data);
+	return image;
+}
+
+/**/
+
+static int _readOffset (const unsigned char* offsets, int index) {
+	int offset;
+	memcpy(&offset, offsets + sizeof(int) * index, sizeof(int));
+	return offset;
+}
+
+static int _attachmentSize (spAttachmentType type) {
+	switch (type) {
+	case SP_ATTACHMENT_REGION:
+		return (int)sizeof(spRegionAttachment);
+	case SP_ATTACHMENT_MESH:
+	case SP_ATTACHMENT_LINKED_MESH:
+		return (int)sizeof(spMeshAttachment);
+	case SP_ATTACHMENT_PATH:
+		return (int)sizeof(spPathAttachment);
+	case SP_ATTACHMENT_POINT:
+		return (int)sizeof(spPointAttachment);
+	case SP_ATTACHMENT_CLIPPING:
+		return (int)sizeof(spClippingAttachment);
+	default:
+		return (int)sizeof(spVertexAttachment);
+	}
+}
+
+static spSkeletonData* _spSkeletonImage_readSkeletonData (spSkeletonImage* self, const _spImageHeader* header, char* data,
+		const unsigned char* offsets) {
+	spSkeletonData* skeletonData;
+	int i;
+
+	for (i = 0; i < header->pointersCount; ++i) {
+		int offset = _readOffset(offsets, i);
+		size_t target;
+		char* pointer;
+		if (offset < 0 || offset > header->size - (int)sizeof(void*) || offset % sizeof(void*)) {
+			_spSkeletonImage_setError(self, "Invalid image.", 0);
+			return 0;
+		}
+		memcpy(&target, data + offset, sizeof(target));
+		if (target >= (size_t)header->size) {
+			_spSkeletonImage_setError(self, "Invalid image.", 0);
+			return 0;
+		}
+		pointer = data + target;
+		memcpy(data + offset, &pointer, sizeof(pointer));
+	}
+	offsets += sizeof(int) * header->pointersCount;
+
+	for (i = 0; i < header->attachmentsCount; ++i) {
+		int offset = _readOffset(offsets, i);
+		spAttachment* attachment;
+		if (offset < 0 || offset > header->size - (int)sizeof(spAttachment)) {
+			_spSkeletonImage_setError(self, "Invalid image.", 0);
+			return 0;
+		}
+		attachment = (spAttachment*)(data + offset);
+		if (offset > header->size - _attachmentSize(attachment->type) || !_spAttachment_setSharedVtable(attachment)) {
+			_spSkeletonImage_setError(self, "Invalid image.", 0);
+			return 0;
+		}
+		if (attachment->type == SP_ATTACHMENT_REGION) {
+			spRegionAttachment* region = SUB_CAST(spRegionAttachment, attachment);
+			region->rendererObject = spAtlas_findRegion(self->atlas, region->path);
+			if (!region->rendererObject) {
+				_spSkeletonImage_setError(self, "Region not found: ", region->path);
+				return 0;
+			}
+		} else if (attachment->type == SP_ATTACHMENT_MESH || attachment->type == SP_ATTACHMENT_LINKED_MESH) {
+			spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, attachment);
+			mesh->rendererObject = spAtlas_findRegion(self->atlas, mesh->path);
+			if (!mesh->rendererObject) {
+				_spSkeletonImage_setError(self, "Region not found: ", mesh->path);
+				return 0;
+			}
+		}
+	}
+	offsets += sizeof(int) * header->attachmentsCount;
+
+	for (i = 0; i < header->timelinesCount; ++i) {
+		int offset = _readOffset(offsets, i);
+		if (offset < 0 || offset > header->size - (int)sizeof(spTimeline)
+				|| !_spTimeline_setSharedVtable((spTimeline*)(data + offset))) {
+			_spSkeletonImage_setError(self, "Invalid image.", 0);
+			return 0;
+		}
+	}
+
+	/* The copy of the root still has the loader's index and arena, a new one starts without them. */
+	skeletonData = spSkeletonData_create();
+	memcpy(skeletonData, data + header->root, sizeof(spSkeletonData));
+	_spSkeletonData_updateIndex(skeletonData);
+	return skeletonData;
+}
+
+spSkeletonData* spSkeletonImage_readSkeletonData (spSkeletonImage* self, const unsigned char* image, const int length) {
+	_spImageHeader header;
+	spSkeletonData* skeletonData;
+	_spArena* arena;
+	_spArena* previous;
+	char* data;
+
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = 0;
+
+	if (length < (int)sizeof(header)) {
+		_spSkeletonImage_setError(self, "Invalid image.", 0);
+		return 0;
+	}
+	memcpy(&header, image, sizeof(header));
+	if (memcmp(header.magic, "SPIM", 4) != 0) {
+		_spSkeletonImage_setError(self, "Invalid image.", 0);
+		return 0;
+	}
+	if (header.version != IMAGE_VERSION || header.layout != _spSkeletonImage_layout()) {
+		_spSkeletonImage_setError(self, "Image was written by an incompatible runtime.", 0);
+		return 0;
+	}
+	if (header.size <= 0 || header.size > length - (int)sizeof(header)
+			|| header.root < 0 || header.root > header.size - (int)sizeof(spSkeletonData)
+			|| header.pointersCount < 0 || header.attachmentsCount < 0 || header.timelinesCount < 0
+			|| (length - (int)sizeof(header) - header.size) / (int)sizeof(int)
+			< header.pointersCount + header.attachmentsCount + header.timelinesCount) {
+		_spSkeletonImage_setError(self, "Invalid image.", 0);
+		return 0;
+	}
+
+	arena = _spArena_create(header.size);
+	previous = _spSetArena(arena);
+	data = MALLOC(char, header.size);
+	memcpy(data, image + sizeof(header), header.size);
+	skeletonData = _spSkeletonImage_readSkeletonData(self, &header, data, image + sizeof(header) + header.size);
+	_spSetArena(previous);
+
+	if (!skeletonData) {
+		_spArena_dispose(arena);
+		return 0;
+	}
+	_spSkeletonData_setArena(skeletonData, arena);
+	return skeletonData;
+}
@@ -77,15 +77,16 @@ void spSkeletonJson_dispose (spSkeletonJson* self) {
 	FREE(self);
 }
 
-void _spSkeletonJson_setError (spSkeletonJson* self, Json* root, const char* value1, const char* value2) {
+void _spSkeletonJson_setError (spSkeletonJson* self, const char* value1, const char* value2) {
 	char message[256];
 	int length;
+	_spArena* arena = _spSetArena(0);
 	FREE(self->error);
 	strcpy(message, value1);
 	length = (int)strlen(value1);
 	if (value2) strncat(message + length, value2, 255 - length);
 	MALLOC_STR(self->error, message);
-	if (root) Json_dispose(root);
+	_spSetArena(arena);
 }
 
 static float toColor (const char* value, int index) {
@@ -127,12 +128,15 @@ static void _spSkeletonJson_addLinkedMesh (spSkeletonJson* self, spMeshAttachmen
 
 	if (internal->linkedMeshCount == internal->linkedMeshCapacity) {
 		_spLinkedMesh* linkedMeshes;
+		/* Kept by the loader across reads, so never in the skeleton data's arena. */
+		_spArena* arena = _spSetArena(0);
 		internal->linkedMeshCapacity *= 2;
 		if (internal->linkedMeshCapacity < 8) internal->linkedMeshCapacity = 8;
 		linkedMeshes = MALLOC(_spLinkedMesh, internal->linkedMeshCapacity);
 		memcpy(linkedMeshes, internal->linkedMeshes, sizeof(_spLinkedMesh) * internal->linkedMeshCount);
 		FREE(internal->linkedMeshes);
 		internal->linkedMeshes = linkedMeshes;
+		_spSetArena(arena);
 	}
 
 	linkedMesh = internal->linkedMeshes + internal->linkedMeshCount++;
@@ -183,7 +187,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		int slotIndex = spSkeletonData_findSlotIndex(skeletonData, slotMap->name);
 		if (slotIndex == -1) {
 			spAnimation_dispose(animation);
-			_spSkeletonJson_setError(self, root, "Slot not found: ", slotMap->name);
+			_spSkeletonJson_setError(self, "Slot not found: ", slotMap->name);
 			return 0;
 		}
 
@@ -229,7 +233,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 			} else {
 				spAnimation_dispose(animation);
-				_spSkeletonJson_setError(self, 0, "Invalid timeline type for a slot: ", timelineMap->name);
+				_spSkeletonJson_setError(self, "Invalid timeline type for a slot: ", timelineMap->name);
 				return 0;
 			}
 		}
@@ -242,7 +246,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		int boneIndex = spSkeletonData_findBoneIndex(skeletonData, boneMap->name);
 		if (boneIndex == -1) {
 			spAnimation_dispose(animation);
-			_spSkeletonJson_setError(self, root, "Bone not found: ", boneMap->name);
+			_spSkeletonJson_setError(self, "Bone not found: ", boneMap->name);
 			return 0;
 		}
 
@@ -280,7 +284,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 
 				} else {
 					spAnimation_dispose(animation);
-					_spSkeletonJson_setError(self, 0, "Invalid timeline type for a bone: ", timelineMap->name);
+					_spSkeletonJson_setError(self, "Invalid timeline type for a bone: ", timelineMap->name);
 					return 0;
 				}
 			}
@@ -333,7 +337,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 		spPathConstraintData* data = spSkeletonData_findPathConstraint(skeletonData, constraintMap->name);
 		if (!data) {
 			spAnimation_dispose(animation);
-			_spSkeletonJson_setError(self, root, "Path constraint not found: ", constraintMap->name);
+			_spSkeletonJson_setError(self, "Path constraint not found: ", constraintMap->name);
 			return 0;
 		}
 		for (i = 0; i < skeletonData->pathConstraintsCount; i++) {
@@ -379,6 +383,8 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 	/* Deform timelines. */
 	for (constraintMap = deform ? deform->child : 0; constraintMap; constraintMap = constraintMap->next) {
 		spSkin* skin = spSkeletonData_findSkin(skeletonData, constraintMap->name);
+		/* Deform timelines of the skins that weren't read are dropped. */
+		if (!skin && !_spContainsName(self->skinNames, self->skinNamesCount, constraintMap->name)) continue;
 		for (slotMap = constraintMap->child; slotMap; slotMap = slotMap->next) {
 			int slotIndex = spSkeletonData_findSlotIndex(skeletonData, slotMap->name);
 			Json* timelineMap;
@@ -390,7 +396,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 				spVertexAttachment* attachment = SUB_CAST(spVertexAttachment, spSkin_getAttachment(skin, slotIndex, timelineMap->name));
 				if (!attachment) {
 					spAnimation_dispose(animation);
-					_spSkeletonJson_setError(self, 0, "Attachment not found: ", timelineMap->name);
+					_spSkeletonJson_setError(self, "Attachment not found: ", timelineMap->name);
 					return 0;
 				}
 				weighted = attachment->bones != 0;
@@ -460,7 +466,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 					int slotIndex = spSkeletonData_findSlotIndex(skeletonData, Json_getString(offsetMap, "slot", 0));
 					if (slotIndex == -1) {
 						spAnimation_dispose(animation);
-						_spSkeletonJson_setError(self, 0, "Slot not found: ", Json_getString(offsetMap, "slot", 0));
+						_spSkeletonJson_setError(self, "Slot not found: ", Json_getString(offsetMap, "slot", 0));
 						return 0;
 					}
 					/* Collect unchanged items. */
@@ -494,7 +500,7 @@ static spAnimation* _spSkeletonJson_readAnimation (spSkeletonJson* self, Json* r
 			spEventData* eventData = spSkeletonData_findEvent(skeletonData, Json_getString(valueMap, "name", 0));
 			if (!eventData) {
 				spAnimation_dispose(animation);
-				_spSkeletonJson_setError(self, 0, "Event not found: ", Json_getString(valueMap, "name", 0));
+				_spSkeletonJson_setError(self, "Event not found: ", Json_getString(valueMap, "name", 0));
 				return 0;
 			}
 			event = spEvent_create(Json_getFloat(valueMap, "time", 0), eventData);
@@ -565,33 +571,22 @@ static void _readVertices (spSkeletonJson* self, Json* attachmentMap, spVertexAt
 spSkeletonData* spSkeletonJson_readSkeletonDataFile (spSkeletonJson* self, const char* path) {
 	int length;
 	spSkeletonData* skeletonData;
-	const char* json = _spUtil_readFile(path, &length);
+	char* json = _spUtil_readFile(path, &length);
 	if (length == 0 || !json) {
-		_spSkeletonJson_setError(self, 0, "Unable to read skeleton file: ", path);
+		_spSkeletonJson_setError(self, "Unable to read skeleton file: ", path);
 		return 0;
 	}
-	skeletonData = spSkeletonJson_readSkeletonData(self, json);
+	skeletonData = spSkeletonJson_readSkeletonDataInPlace(self, json);
 	FREE(json);
 	return skeletonData;
 }
 
-spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const char* json) {
+static spSkeletonData* _spSkeletonJson_readSkeletonData (spSkeletonJson* self, Json* root) {
 	int i, ii;
 	spSkeletonData* skeletonData;
-	Json *root, *skeleton, *bones, *boneMap, *ik, *transform, *path, *slots, *skins, *animations, *events;
+	Json *skeleton, *bones, *boneMap, *ik, *transform, *path, *slots, *skins, *animations, *events;
 	_spSkeletonJson* internal = SUB_CAST(_spSkeletonJson, self);
 
-	FREE(self->error);
-	CONST_CAST(char*, self->error) = 0;
-	internal->linkedMeshCount = 0;
-
-	root = Json_create(json);
-
-	if (!root) {
-		_spSkeletonJson_setError(self, 0, "Invalid skeleton JSON: ", Json_getError());
-		return 0;
-	}
-
 	skeletonData = spSkeletonData_create();
 
 	skeleton = Json_getItem(root, "skeleton");
@@ -615,7 +610,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			parent = spSkeletonData_findBone(skeletonData, parentName);
 			if (!parent) {
 				spSkeletonData_dispose(skeletonData);
-				_spSkeletonJson_setError(self, root, "Parent bone not found: ", parentName);
+				_spSkeletonJson_setError(self, "Parent bone not found: ", parentName);
 				return 0;
 			}
 		}
@@ -662,7 +657,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			spBoneData* boneData = spSkeletonData_findBone(skeletonData, boneName);
 			if (!boneData) {
 				spSkeletonData_dispose(skeletonData);
-				_spSkeletonJson_setError(self, root, "Slot bone not found: ", boneName);
+				_spSkeletonJson_setError(self, "Slot bone not found: ", boneName);
 				return 0;
 			}
 
@@ -723,7 +718,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 				data->bones[ii] = spSkeletonData_findBone(skeletonData, boneMap->valueString);
 				if (!data->bones[ii]) {
 					spSkeletonData_dispose(skeletonData);
-					_spSkeletonJson_setError(self, root, "IK bone not found: ", boneMap->valueString);
+					_spSkeletonJson_setError(self, "IK bone not found: ", boneMap->valueString);
 					return 0;
 				}
 			}
@@ -732,7 +727,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			data->target = spSkeletonData_findBone(skeletonData, targetName);
 			if (!data->target) {
 				spSkeletonData_dispose(skeletonData);
-				_spSkeletonJson_setError(self, root, "Target bone not found: ", targetName);
+				_spSkeletonJson_setError(self, "Target bone not found: ", targetName);
 				return 0;
 			}
 
@@ -762,7 +757,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 				data->bones[ii] = spSkeletonData_findBone(skeletonData, boneMap->valueString);
 				if (!data->bones[ii]) {
 					spSkeletonData_dispose(skeletonData);
-					_spSkeletonJson_setError(self, root, "Transform bone not found: ", boneMap->valueString);
+					_spSkeletonJson_setError(self, "Transform bone not found: ", boneMap->valueString);
 					return 0;
 				}
 			}
@@ -771,7 +766,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			data->target = spSkeletonData_findBone(skeletonData, name);
 			if (!data->target) {
 				spSkeletonData_dispose(skeletonData);
-				_spSkeletonJson_setError(self, root, "Target bone not found: ", name);
+				_spSkeletonJson_setError(self, "Target bone not found: ", name);
 				return 0;
 			}
 
@@ -813,7 +808,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 				data->bones[ii] = spSkeletonData_findBone(skeletonData, boneMap->valueString);
 				if (!data->bones[ii]) {
 					spSkeletonData_dispose(skeletonData);
-					_spSkeletonJson_setError(self, root, "Path bone not found: ", boneMap->valueString);
+					_spSkeletonJson_setError(self, "Path bone not found: ", boneMap->valueString);
 					return 0;
 				}
 			}
@@ -822,7 +817,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			data->target = spSkeletonData_findSlot(skeletonData, name);
 			if (!data->target) {
 				spSkeletonData_dispose(skeletonData);
-				_spSkeletonJson_setError(self, root, "Target slot not found: ", name);
+				_spSkeletonJson_setError(self, "Target slot not found: ", name);
 				return 0;
 			}
 
@@ -860,7 +855,10 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 		for (skinMap = skins->child, i = 0; skinMap; skinMap = skinMap->next, ++i) {
 			Json *attachmentsMap;
 			Json *curves;
-			spSkin *skin = spSkin_create(skinMap->name);
+			spSkin *skin;
+			if (strcmp(skinMap->name, "default") != 0
+					&& !_spContainsName(self->skinNames, self->skinNamesCount, skinMap->name)) continue;
+			skin = spSkin_create(skinMap->name);
 
 			skeletonData->skins[skeletonData->skinsCount++] = skin;
 			if (strcmp(skinMap->name, "default") == 0) skeletonData->defaultSkin = skin;
@@ -893,7 +891,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 						type = SP_ATTACHMENT_CLIPPING;
 					else {
 						spSkeletonData_dispose(skeletonData);
-						_spSkeletonJson_setError(self, root, "Unknown attachment type: ", typeString);
+						_spSkeletonJson_setError(self, "Unknown attachment type: ", typeString);
 						return 0;
 					}
 
@@ -901,7 +899,7 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 					if (!attachment) {
 						if (self->attachmentLoader->error1) {
 							spSkeletonData_dispose(skeletonData);
-							_spSkeletonJson_setError(self, root, self->attachmentLoader->error1, self->attachmentLoader->error2);
+							_spSkeletonJson_setError(self, self->attachmentLoader->error1, self->attachmentLoader->error2);
 							return 0;
 						}
 						continue;
@@ -1057,13 +1055,13 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 		spSkin* skin = !linkedMesh->skin ? skeletonData->defaultSkin : spSkeletonData_findSkin(skeletonData, linkedMesh->skin);
 		if (!skin) {
 			spSkeletonData_dispose(skeletonData);
-			_spSkeletonJson_setError(self, 0, "Skin not found: ", linkedMesh->skin);
+			_spSkeletonJson_setError(self, "Skin not found: ", linkedMesh->skin);
 			return 0;
 		}
 		parent = spSkin_getAttachment(skin, linkedMesh->slotIndex, linkedMesh->parent);
 		if (!parent) {
 			spSkeletonData_dispose(skeletonData);
-			_spSkeletonJson_setError(self, 0, "Parent mesh not found: ", linkedMesh->parent);
+			_spSkeletonJson_setError(self, "Parent mesh not found: ", linkedMesh->parent);
 			return 0;
 		}
 		spMeshAttachment_setParentMesh(linkedMesh->mesh, SUB_CAST(spMeshAttachment, parent));
@@ -1088,13 +1086,18 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 		}
 	}
 
+	/* Index what animations look up by name, then again once the animations are added. */
+	_spSkeletonData_updateIndex(skeletonData);
+
 	/* Animations. */
 	animations = Json_getItem(root, "animations");
 	if (animations) {
 		Json *animationMap;
 		skeletonData->animations = MALLOC(spAnimation*, animations->size);
 		for (animationMap = animations->child; animationMap; animationMap = animationMap->next) {
-			spAnimation* animation = _spSkeletonJson_readAnimation(self, animationMap, skeletonData);
+			spAnimation* animation;
+			if (!_spContainsName(self->animationNames, self->animationNamesCount, animationMap->name)) continue;
+			animation = _spSkeletonJson_readAnimation(self, animationMap, skeletonData);
 			if (!animation) {
 				spSkeletonData_dispose(skeletonData);
 				return 0;
@@ -1102,7 +1105,52 @@ spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const cha
 			skeletonData->animations[skeletonData->animationsCount++] = animation;
 		}
 	}
+	_spSkeletonData_updateIndex(skeletonData);
+
+	return skeletonData;
+}
+
+spSkeletonData* spSkeletonJson_readSkeletonData (spSkeletonJson* self, const char* json) {
+	spSkeletonData* skeletonData;
+	char* copy;
+	_spArena* arena = _spSetArena(0);
+	/* Parsing a private copy in place costs one allocation instead of one for every string. */
+	MALLOC_STR(copy, json);
+	_spSetArena(arena);
+	skeletonData = spSkeletonJson_readSkeletonDataInPlace(self, copy);
+	FREE(copy);
+	return skeletonData;
+}
+
+spSkeletonData* spSkeletonJson_readSkeletonDataInPlace (spSkeletonJson* self, char* json) {
+	spSkeletonData* skeletonData;
+	Json* root;
+	_spArena* arena;
+	_spArena* previous;
+	_spSkeletonJson* internal = SUB_CAST(_spSkeletonJson, self);
+
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = 0;
+	internal->linkedMeshCount = 0;
+
+	root = Json_createInPlace(json);
+
+	if (!root) {
+		_spSkeletonJson_setError(self, "Invalid skeleton JSON: ", Json_getError());
+		return 0;
+	}
 
-	Json_dispose(root);
+	/* The parsed tree stays out of the arena, it is freed as soon as the data is read. */
+	arena = self->useArena ? _spArena_create(32 * 1024) : 0;
+	previous = _spSetArena(arena);
+	skeletonData = _spSkeletonJson_readSkeletonData(self, root);
+	_spSetArena(previous);
+	Json_disposeInPlace(root);
+	if (arena) {
+		if (skeletonData)
+			_spSkeletonData_setArena(skeletonData, arena);
+		else
+			_spArena_dispose(arena);
+	}
 	return skeletonData;
 }
@@ -32,9 +32,22 @@
 #include <spine/Skeleton.h>
 #include <spine/extension.h>
 
+#define TRANSFORMCONSTRAINT_ROTATE 1
+#define TRANSFORMCONSTRAINT_TRANSLATE 2
+#define TRANSFORMCONSTRAINT_SCALE 4
+#define TRANSFORMCONSTRAINT_SHEAR 8
+
+typedef void (*_spTransformConstraintApply) (spTransformConstraint* self);
+
+typedef struct {
+	spTransformConstraint super;
+	int mixes; /* Mixes the apply function was selected for. */
+	_spTransformConstraintApply apply;
+} _spTransformConstraint;
+
 spTransformConstraint* spTransformConstraint_create (spTransformConstraintData* data, const spSkeleton* skeleton) {
 	int i;
-	spTransformConstraint* self = NEW(spTransformConstraint);
+	spTransformConstraint* self = SUPER(NEW(_spTransformConstraint));
 	CONST_CAST(spTransformConstraintData*, self->data) = data;
 	self->rotateMix = data->rotateMix;
 	self->translateMix = data->translateMix;
@@ -45,6 +58,7 @@ spTransformConstraint* spTransformConstraint_create (spTransformConstraintData*
 	for (i = 0; i < self->bonesCount; ++i)
 		self->bones[i] = spSkeleton_findBone(skeleton, self->data->bones[i]->name);
 	self->target = spSkeleton_findBone(skeleton, self->data->target->name);
+	_spTransformConstraint_updateApply(self);
 	return self;
 }
 
@@ -53,22 +67,77 @@ void spTransformConstraint_dispose (spTransformConstraint* self) {
 	FREE(self);
 }
 
-void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
+static int _spTransformConstraint_getMixes (const spTransformConstraint* self) {
+	int mixes = 0;
+	if (self->rotateMix != 0) mixes |= TRANSFORMCONSTRAINT_ROTATE;
+	if (self->translateMix != 0) mixes |= TRANSFORMCONSTRAINT_TRANSLATE;
+	if (self->scaleMix > 0) mixes |= TRANSFORMCONSTRAINT_SCALE;
+	if (self->shearMix > 0) mixes |= TRANSFORMCONSTRAINT_SHEAR;
+	return mixes;
+}
+
+static void _spTransformConstraint_applyNone (spTransformConstraint* self) {
+	UNUSED(self);
+}
+
+static void _spTransformConstraint_applyAbsoluteWorldRotate (spTransformConstraint* self) {
+	float rotateMix = self->rotateMix;
+	spBone* target = self->target;
+	float ta = target->a, tb = target->b, tc = target->c, td = target->d;
+	float degRadReflect = ta * td - tb * tc > 0 ? DEG_RAD : -DEG_RAD;
+	float offsetRotation = self->data->offsetRotation * degRadReflect;
+	float targetRotation = ATAN2(tc, ta);
+	int i;
+	float a, b, c, d, r, cosine, sine;
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		a = bone->a, b = bone->b, c = bone->c, d = bone->d;
+		r = targetRotation - ATAN2(c, a) + offsetRotation;
+		if (r > PI) r -= PI2;
+		else if (r < -PI) r += PI2;
+		r *= rotateMix;
+		cosine = COS(r);
+		sine = SIN(r);
+		CONST_CAST(float, bone->a) = cosine * a - sine * c;
+		CONST_CAST(float, bone->b) = cosine * b - sine * d;
+		CONST_CAST(float, bone->c) = sine * a + cosine * c;
+		CONST_CAST(float, bone->d) = sine * b + cosine * d;
+		CONST_CAST(int, bone->appliedValid) = 0;
+	}
+}
+
+static void _spTransformConstraint_applyAbsoluteWorldTranslate (spTransformConstraint* self) {
+	float translateMix = self->translateMix;
+	int i;
+	float x, y;
+	spBone_localToWorld(self->target, self->data->offsetX, self->data->offsetY, &x, &y);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		CONST_CAST(float, bone->worldX) += (x - bone->worldX) * translateMix;
+		CONST_CAST(float, bone->worldY) += (y - bone->worldY) * translateMix;
+		CONST_CAST(int, bone->appliedValid) = 0;
+	}
+}
+
+static void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 	float rotateMix = self->rotateMix, translateMix = self->translateMix, scaleMix = self->scaleMix, shearMix = self->shearMix;
 	spBone* target = self->target;
 	float ta = target->a, tb = target->b, tc = target->c, td = target->d;
 	float degRadReflect = ta * td - tb * tc > 0 ? DEG_RAD : -DEG_RAD;
 	float offsetRotation = self->data->offsetRotation * degRadReflect, offsetShearY = self->data->offsetShearY * degRadReflect;
+	float targetRotation = ATAN2(tc, ta), targetShear = ATAN2(td, tb) - targetRotation;
+	float targetScaleX = SQRT(ta * ta + tc * tc), targetScaleY = SQRT(tb * tb + td * td);
 	int /*bool*/ modified;
 	int i;
-	float a, b, c, d, r, cosine, sine, x, y, s, ts, by;
+	float a, b, c, d, r, cosine, sine, x = 0, y = 0, s, by;
+	if (translateMix != 0) spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBone* bone = self->bones[i];
 		modified = 0;
 
 		if (rotateMix != 0) {
 			a = bone->a, b = bone->b, c = bone->c, d = bone->d;
-			r = ATAN2(tc, ta) - ATAN2(c, a) + offsetRotation;
+			r = targetRotation - ATAN2(c, a) + offsetRotation;
 			if (r > PI) r -= PI2;
 			else if (r < -PI) r += PI2;
 			r *= rotateMix;
@@ -82,7 +151,6 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 		}
 
 		if (translateMix != 0) {
-			spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
 			CONST_CAST(float, bone->worldX) += (x - bone->worldX) * translateMix;
 			CONST_CAST(float, bone->worldY) += (y - bone->worldY) * translateMix;
 			modified = 1;
@@ -90,13 +158,11 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 
 		if (scaleMix > 0) {
 			s = SQRT(bone->a * bone->a + bone->c * bone->c);
-			ts = SQRT(ta * ta + tc * tc);
-			if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleX) * scaleMix) / s;
+			if (s > 0.00001f) s = (s + (targetScaleX - s + self->data->offsetScaleX) * scaleMix) / s;
 			CONST_CAST(float, bone->a) *= s;
 			CONST_CAST(float, bone->c) *= s;
 			s = SQRT(bone->b * bone->b + bone->d * bone->d);
-			ts = SQRT(tb * tb + td * td);
-			if (s > 0.00001f) s = (s + (ts - s + self->data->offsetScaleY) * scaleMix) / s;
+			if (s > 0.00001f) s = (s + (targetScaleY - s + self->data->offsetScaleY) * scaleMix) / s;
 			CONST_CAST(float, bone->b) *= s;
 			CONST_CAST(float, bone->d) *= s;
 			modified = 1;
@@ -105,7 +171,7 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 		if (shearMix > 0) {
 			b = bone->b, d = bone->d;
 			by = ATAN2(d, b);
-			r = ATAN2(td, tb) - ATAN2(tc, ta) - (by - ATAN2(bone->c, bone->a));
+			r = targetShear - (by - ATAN2(bone->c, bone->a));
 			s = SQRT(b * b + d * d);
 			if (r > PI) r -= PI2;
 			else if (r < -PI) r += PI2;
@@ -119,7 +185,44 @@ void _spTransformConstraint_applyAbsoluteWorld (spTransformConstraint* self) {
 	}
 }
 
-void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
+/* The rotation only depends on the target, so it is computed once for all bones. */
+static void _spTransformConstraint_applyRelativeWorldRotate (spTransformConstraint* self) {
+	spBone* target = self->target;
+	float ta = target->a, tb = target->b, tc = target->c, td = target->d;
+	float degRadReflect = ta * td - tb * tc > 0 ? DEG_RAD : -DEG_RAD;
+	float r = ATAN2(tc, ta) + self->data->offsetRotation * degRadReflect, cosine, sine;
+	int i;
+	float a, b, c, d;
+	if (r > PI) r -= PI2;
+	else if (r < -PI) r += PI2;
+	r *= self->rotateMix;
+	cosine = COS(r);
+	sine = SIN(r);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		a = bone->a, b = bone->b, c = bone->c, d = bone->d;
+		CONST_CAST(float, bone->a) = cosine * a - sine * c;
+		CONST_CAST(float, bone->b) = cosine * b - sine * d;
+		CONST_CAST(float, bone->c) = sine * a + cosine * c;
+		CONST_CAST(float, bone->d) = sine * b + cosine * d;
+		CONST_CAST(int, bone->appliedValid) = 0;
+	}
+}
+
+static void _spTransformConstraint_applyRelativeWorldTranslate (spTransformConstraint* self) {
+	float translateMix = self->translateMix;
+	int i;
+	float x, y;
+	spBone_localToWorld(self->target, self->data->offsetX, self->data->offsetY, &x, &y);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		CONST_CAST(float, bone->worldX) += (x * translateMix);
+		CONST_CAST(float, bone->worldY) += (y * translateMix);
+		CONST_CAST(int, bone->appliedValid) = 0;
+	}
+}
+
+static void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 	float rotateMix = self->rotateMix, translateMix = self->translateMix, scaleMix = self->scaleMix, shearMix = self->shearMix;
 	spBone* target = self->target;
 	float ta = target->a, tb = target->b, tc = target->c, td = target->d;
@@ -127,19 +230,35 @@ void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 	float offsetRotation = self->data->offsetRotation * degRadReflect, offsetShearY = self->data->offsetShearY * degRadReflect;
 	int /*bool*/ modified;
 	int i;
-	float a, b, c, d, r, cosine, sine, x, y, s;
+	float a, b, c, d, r, cosine = 0, sine = 0, x = 0, y = 0, s, scaleX = 0, scaleY = 0, shear = 0;
+
+	/* Everything but the shear depends only on the target. */
+	if (rotateMix != 0) {
+		r = ATAN2(tc, ta) + offsetRotation;
+		if (r > PI) r -= PI2;
+		else if (r < -PI) r += PI2;
+		r *= rotateMix;
+		cosine = COS(r);
+		sine = SIN(r);
+	}
+	if (translateMix != 0) spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
+	if (scaleMix > 0) {
+		scaleX = (SQRT(ta * ta + tc * tc) - 1 + self->data->offsetScaleX) * scaleMix + 1;
+		scaleY = (SQRT(tb * tb + td * td) - 1 + self->data->offsetScaleY) * scaleMix + 1;
+	}
+	if (shearMix > 0) {
+		r = ATAN2(td, tb) - ATAN2(tc, ta);
+		if (r > PI) r -= PI2;
+		else if (r < -PI) r += PI2;
+		shear = (r - PI / 2 + offsetShearY) * shearMix;
+	}
+
 	for (i = 0; i < self->bonesCount; ++i) {
 		spBone* bone = self->bones[i];
 		modified = 0;
 
 		if (rotateMix != 0) {
 			a = bone->a, b = bone->b, c = bone->c, d = bone->d;
-			r = ATAN2(tc, ta) + offsetRotation;
-			if (r > PI) r -= PI2;
-			else if (r < -PI) r += PI2;
-			r *= rotateMix;
-			cosine = COS(r);
-			sine = SIN(r);
 			CONST_CAST(float, bone->a) = cosine * a - sine * c;
 			CONST_CAST(float, bone->b) = cosine * b - sine * d;
 			CONST_CAST(float, bone->c) = sine * a + cosine * c;
@@ -148,28 +267,22 @@ void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 		}
 
 		if (translateMix != 0) {
-			spBone_localToWorld(target, self->data->offsetX, self->data->offsetY, &x, &y);
 			CONST_CAST(float, bone->worldX) += (x * translateMix);
 			CONST_CAST(float, bone->worldY) += (y * translateMix);
 			modified = 1;
 		}
 
 		if (scaleMix > 0) {
-			s = (SQRT(ta * ta + tc * tc) - 1 + self->data->offsetScaleX) * scaleMix + 1;
-			CONST_CAST(float, bone->a) *= s;
-			CONST_CAST(float, bone->c) *= s;
-			s = (SQRT(tb * tb + td * td) - 1 + self->data->offsetScaleY) * scaleMix + 1;
-			CONST_CAST(float, bone->b) *= s;
-			CONST_CAST(float, bone->d) *= s;
+			CONST_CAST(float, bone->a) *= scaleX;
+			CONST_CAST(float, bone->c) *= scaleX;
+			CONST_CAST(float, bone->b) *= scaleY;
+			CONST_CAST(float, bone->d) *= scaleY;
 			modified = 1;
 		}
 
 		if (shearMix > 0) {
-			r = ATAN2(td, tb) - ATAN2(tc, ta);
-			if (r > PI) r -= PI2;
-			else if (r < -PI) r += PI2;
 			b = bone->b, d = bone->d;
-			r = ATAN2(d, b) + (r - PI / 2 + offsetShearY) * shearMix;
+			r = ATAN2(d, b) + shear;
 			s = SQRT(b * b + d * d);
 			CONST_CAST(float, bone->b) = COS(r) * s;
 			CONST_CAST(float, bone->d) = SIN(r) * s;
@@ -180,7 +293,27 @@ void _spTransformConstraint_applyRelativeWorld (spTransformConstraint* self) {
 	}
 }
 
-void _spTransformConstraint_applyAbsoluteLocal (spTransformConstraint* self) {
+static void _spTransformConstraint_applyAbsoluteLocalRotate (spTransformConstraint* self) {
+	float rotateMix = self->rotateMix;
+	spBone* target = self->target;
+	int i;
+	float rotation, r;
+
+	if (!target->appliedValid) spBone_updateAppliedTransform(target);
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		if (!bone->appliedValid) spBone_updateAppliedTransform(bone);
+
+		rotation = bone->arotation;
+		r = target->arotation - rotation + self->data->offsetRotation;
+		r -= (16384 - (int)(16384.499999999996 - r / 360)) * 360;
+		rotation += r * rotateMix;
+
+		spBone_updateWorldTransformWith(bone, bone->ax, bone->ay, rotation, bone->ascaleX, bone->ascaleY, bone->ashearX, bone->ashearY);
+	}
+}
+
+static void _spTransformConstraint_applyAbsoluteLocal (spTransformConstraint* self) {
 	float rotateMix = self->rotateMix, translateMix = self->translateMix, scaleMix = self->scaleMix, shearMix = self->shearMix;
 	spBone* target = self->target;
 	int i;
@@ -221,7 +354,23 @@ void _spTransformConstraint_applyAbsoluteLocal (spTransformConstraint* self) {
 	}
 }
 
-void _spTransformConstraint_applyRelativeLocal (spTransformConstraint* self) {
+static void _spTransformConstraint_applyRelativeLocalRotate (spTransformConstraint* self) {
+	spBone* target = self->target;
+	int i;
+	float rotation;
+
+	if (!target->appliedValid) spBone_updateAppliedTransform(target);
+	rotation = (target->arotation + self->data->offsetRotation) * self->rotateMix;
+
+	for (i = 0; i < self->bonesCount; ++i) {
+		spBone* bone = self->bones[i];
+		if (!bone->appliedValid) spBone_updateAppliedTransform(bone);
+		spBone_updateWorldTransformWith(bone, bone->ax, bone->ay, bone->arotation + rotation, bone->ascaleX, bone->ascaleY,
+			bone->ashearX, bone->ashearY);
+	}
+}
+
+static void _spTransformConstraint_applyRelativeLocal (spTransformConstraint* self) {
 	float rotateMix = self->rotateMix, translateMix = self->translateMix, scaleMix = self->scaleMix, shearMix = self->shearMix;
 	spBone* target = self->target;
 	int i;
@@ -257,17 +406,42 @@ void _spTransformConstraint_applyRelativeLocal (spTransformConstraint* self) {
 	}
 }
 
-void spTransformConstraint_apply (spTransformConstraint* self) {
-	if (self->data->local) {
-		if (self->data->relative)
-			_spTransformConstraint_applyRelativeLocal(self);
-		else
-			_spTransformConstraint_applyAbsoluteLocal(self);
+void _spTransformConstraint_updateApply (spTransformConstraint* self) {
+	_spTransformConstraint* internal = SUB_CAST(_spTransformConstraint, self);
+	int mixes = _spTransformConstraint_getMixes(self);
+	internal->mixes = mixes;
 
-	} else {
+	if (mixes == 0)
+		internal->apply = _spTransformConstraint_applyNone;
+	else if (self->data->local) {
 		if (self->data->relative)
-			_spTransformConstraint_applyRelativeWorld(self);
+			internal->apply = mixes == TRANSFORMCONSTRAINT_ROTATE ? _spTransformConstraint_applyRelativeLocalRotate
+				: _spTransformConstraint_applyRelativeLocal;
 		else
-			_spTransformConstraint_applyAbsoluteWorld(self);
+			internal->apply = mixes == TRANSFORMCONSTRAINT_ROTATE ? _spTransformConstraint_applyAbsoluteLocalRotate
+				: _spTransformConstraint_applyAbsoluteLocal;
+	} else {
+		if (self->data->relative) {
+			if (mixes == TRANSFORMCONSTRAINT_ROTATE)
+				internal->apply = _spTransformConstraint_applyRelativeWorldRotate;
+			else if (mixes == TRANSFORMCONSTRAINT_TRANSLATE)
+				internal->apply = _spTransformConstraint_applyRelativeWorldTranslate;
+			else
+				internal->apply = _spTransformConstraint_applyRelativeWorld;
+		} else {
+			if (mixes == TRANSFORMCONSTRAINT_ROTATE)
+				internal->apply = _spTransformConstraint_applyAbsoluteWorldRotate;
+			else if (mixes == TRANSFORMCONSTRAINT_TRANSLATE)
+				internal->apply = _spTransformConstraint_applyAbsoluteWorldTranslate;
+			else
+				internal->apply = _spTransformConstraint_applyAbsoluteWorld;
+		}
 	}
 }
+
+void spTransformConstraint_apply (spTransformConstraint* self) {
+	_spTransformConstraint* internal = SUB_CAST(_spTransformConstraint, self);
+	/* Mix timelines can change the mixes after the apply function was selected. */
+	if (_spTransformConstraint_getMixes(self) != internal->mixes) _spTransformConstraint_updateApply(self);
+	internal->apply(self);
+}
@@ -31,8 +31,8 @@
 #include <spine/VertexAttachment.h>
 #include <spine/extension.h>
 
-/* FIXME this is not thread-safe */
-static int nextID = 0;
+/* Per thread: the attachments of one skeleton data are all created by the thread loading it. */
+static SP_THREAD_LOCAL int nextID = 0;
 
 void _spVertexAttachment_init (spVertexAttachment* attachment) {
 	attachment->id = (nextID++ & 65535) << 11;
@@ -41,7 +41,18 @@ static void* (*debugMallocFunc) (size_t size, const char* file, int line) = NULL
 static void (*freeFunc) (void* ptr) = free;
 static float (*randomFunc) () = _spInternalRandom;
 
+static SP_THREAD_LOCAL _spArena* currentArena = 0;
+static SP_THREAD_LOCAL int allocationCount = 0;
+
+static void* _spArena_malloc (_spArena* self, size_t size);
+static void* _spArena_realloc (_spArena* self, void* ptr, size_t size);
+static void _spArena_free (_spArena* self, void* ptr);
+
 void* _spMalloc (size_t size, const char* file, int line) {
+	if (currentArena)
+		return _spArena_malloc(currentArena, size);
+
+	++allocationCount;
 	if(debugMallocFunc)
 		return debugMallocFunc(size, file, line);
 
@@ -53,9 +64,16 @@ void* _spCalloc (size_t num, size_t size, const char* file, int line) {
 	return ptr;
 }
 void* _spRealloc(void* ptr, size_t size) {
+	if (currentArena && (!ptr || _spArena_contains(currentArena, ptr)))
+		return _spArena_realloc(currentArena, ptr, size);
+	++allocationCount;
 	return reallocFunc(ptr, size);
 }
 void _spFree (void* ptr) {
+	if (currentArena && _spArena_contains(currentArena, ptr)) {
+		_spArena_free(currentArena, ptr);
+		return;
+	}
 	freeFunc(ptr);
 }
 
@@ -83,6 +101,178 @@ void _spSetRandom (float (*random) ()) {
 	randomFunc = random;
 }
 
+int _spGetAllocationCount () {
+	return allocationCount;
+}
+
+/**/
+
+#define ARENA_ALIGN 8
+#define ARENA_ROUND(SIZE) (((SIZE) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+/* Each allocation is preceded by its size so realloc can copy it. */
+#define ARENA_HEADER ARENA_ROUND(sizeof(size_t))
+/* Bytes taken by an allocation. Empty ones take some too, so their pointer is inside the block. */
+#define ARENA_SPAN(SIZE) (ARENA_HEADER + ARENA_ROUND((SIZE) ? (SIZE) : 1))
+#define ARENA_MIN_BLOCK 4096
+#define ARENA_MAX_BLOCK (4 * 1024 * 1024)
+
+typedef struct _spArenaBlock {
+	struct _spArenaBlock* next;
+	char* data;
+	size_t capacity;
+	size_t used;
+	size_t last; /* Offset of the most recent allocation, which can be grown or given back in place. */
+} _spArenaBlock;
+
+struct _spArena {
+	_spArenaBlock* blocks; /* The first block is the one being filled. */
+	int blocksCount;
+	size_t blockSize;
+	size_t size;
+	int allocationsCount;
+};
+
+static _spArenaBlock* _spArenaBlock_create (size_t capacity) {
+	_spArenaBlock* self = (_spArenaBlock*)mallocFunc(ARENA_ROUND(sizeof(_spArenaBlock)) + capacity);
+	++allocationCount;
+	if (!self) return 0;
+	self->next = 0;
+	self->data = (char*)self + ARENA_ROUND(sizeof(_spArenaBlock));
+	self->capacity = capacity;
+	self->used = 0;
+	self->last = 0;
+	return self;
+}
+
+_spArena* _spArena_create (size_t blockSize) {
+	_spArena* self = (_spArena*)mallocFunc(sizeof(_spArena));
+	++allocationCount;
+	if (!self) return 0;
+	self->blocks = 0;
+	self->blocksCount = 0;
+	self->blockSize = ARENA_ROUND(blockSize < ARENA_MIN_BLOCK ? ARENA_MIN_BLOCK : blockSize > ARENA_MAX_BLOCK ? ARENA_MAX_BLOCK : blockSize);
+	self->size = 0;
+	self->allocationsCount = 0;
+	return self;
+}
+
+void _spArena_dispose (_spArena* self) {
+	_spArenaBlock* block = self->blocks;
+	while (block) {
+		_spArenaBlock* next = block->next;
+		freeFunc(block);
+		block = next;
+	}
+	freeFunc(self);
+}
+
+int _spArena_contains (const _spArena* self, const void* ptr) {
+	const _spArenaBlock* block;
+	for (block = self->blocks; block; block = block->next)
+		if ((const char*)ptr >= block->data && (const char*)ptr < block->data + block->used) return 1;
+	return 0;
+}
+
+void _spArena_getStats (const _spArena* self, int* blocksCount, size_t* size, int* allocationsCount) {
+	if (blocksCount) *blocksCount = self->blocksCount;
+	if (size) *size = self->size;
+	if (allocationsCount) *allocationsCount = self->allocationsCount;
+}
+
+size_t _spArena_getUsedSize (const _spArena* self) {
+	const _spArenaBlock* block;
+	size_t size = 0;
+	for (block = self->blocks; block; block = block->next)
+		size += block->used;
+	return size;
+}
+
+void _spArena_copyUsed (const _spArena* self, void* data) {
+	const _spArenaBlock* block;
+	char* cursor = (char*)data;
+	for (block = self->blocks; block; block = block->next) {
+		memcpy(cursor, block->data, block->used);
+		cursor += block->used;
+	}
+}
+
+int _spArena_getUsedOffset (const _spArena* self, const void* ptr) {
+	const _spArenaBlock* block;
+	size_t offset = 0;
+	for (block = self->blocks; block; block = block->next) {
+		if ((const char*)ptr >= block->data && (const char*)ptr < block->data + block->used)
+			return (int)(offset + ((const char*)ptr - block->data));
+		offset += block->used;
+	}
+	return -1;
+}
+
+_spArena* _spSetArena (_spArena* arena) {
+	_spArena* previous = currentArena;
+	currentArena = arena;
+	return previous;
+}
+
+static void* _spArena_malloc (_spArena* self, size_t size) {
+	size_t needed = ARENA_SPAN(size);
+	_spArenaBlock* block = self->blocks;
+	char* header;
+	if (!block || block->capacity - block->used < needed) {
+		if (needed > self->blockSize / 2) {
+			/* Large allocations get a block of their own, behind the one being filled. */
+			block = _spArenaBlock_create(needed);
+			if (!block) return 0;
+			if (self->blocks) {
+				block->next = self->blocks->next;
+				self->blocks->next = block;
+			} else
+				self->blocks = block;
+		} else {
+			block = _spArenaBlock_create(self->blockSize);
+			if (!block) return 0;
+			block->next = self->blocks;
+			self->blocks = block;
+			if (self->blockSize < ARENA_MAX_BLOCK) self->blockSize <<= 1;
+		}
+		++self->blocksCount;
+	}
+	header = block->data + block->used;
+	*(size_t*)header = size;
+	block->last = block->used;
+	block->used += needed;
+	self->size += size;
+	++self->allocationsCount;
+	return header + ARENA_HEADER;
+}
+
+static void* _spArena_realloc (_spArena* self, void* ptr, size_t size) {
+	_spArenaBlock* block = self->blocks;
+	char* header;
+	size_t oldSize;
+	void* result;
+	if (!ptr) return _spArena_malloc(self, size);
+	header = (char*)ptr - ARENA_HEADER;
+	oldSize = *(size_t*)header;
+	if (header == block->data + block->last && block->last + ARENA_SPAN(size) <= block->capacity) {
+		*(size_t*)header = size;
+		block->used = block->last + ARENA_SPAN(size);
+		self->size = self->size - oldSize + size;
+		return ptr;
+	}
+	if (size <= oldSize) return ptr;
+	result = _spArena_malloc(self, size);
+	if (result) memcpy(result, ptr, oldSize);
+	return result;
+}
+
+static void _spArena_free (_spArena* self, void* ptr) {
+	_spArenaBlock* block = self->blocks;
+	char* header = (char*)ptr - ARENA_HEADER;
+	if (header != block->data + block->last || block->used == block->last) return;
+	self->size -= *(size_t*)header;
+	block->used = block->last;
+}
+
 char* _spReadFile (const char* path, int* length) {
 	char *data;
 	FILE *file = fopen(path, "rb");
@@ -126,3 +316,96 @@ float _spMath_pow2_apply(float a) {
 float _spMath_pow2out_apply(float a) {
 	return POW(a - 1, 2) * -1 + 1;
 }
+
+static unsigned int _spNameTable_hash (const char* name) {
+	/* FNV-1a */
+	unsigned int hash = 2166136261u;
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void _spNameTable_init (_spNameTable* self, const char** names, int namesCount) {
+	int i;
+	self->names = names;
+	self->namesCount = namesCount;
+	self->capacity = 8;
+	while (self->capacity < namesCount * 2)
+		self->capacity <<= 1;
+	self->entries = CALLOC(int, self->capacity);
+	for (i = 0; i < namesCount; ++i) {
+		unsigned int bucket;
+		if (!names[i] || _spNameTable_find(self, names[i]) != -1) continue;
+		bucket = _spNameTable_hash(names[i]) & (self->capacity - 1);
+		while (self->entries[bucket])
+			bucket = (bucket + 1) & (self->capacity - 1);
+		self->entries[bucket] = i + 1;
+	}
+}
+
+void _spNameTable_deinit (_spNameTable* self) {
+	FREE(self->names);
+	FREE(self->entries);
+	self->names = 0;
+	self->namesCount = 0;
+	self->entries = 0;
+	self->capacity = 0;
+}
+
+void _spStateBuffer_init (_spStateBuffer* self, const void* data, int capacity) {
+	self->data = (char*)data;
+	self->capacity = capacity;
+	self->size = 0;
+	self->error = 0;
+}
+
+void _spStateBuffer_write (_spStateBuffer* self, const void* data, int size) {
+	if (size > 0 && self->size + size <= self->capacity) memcpy(self->data + self->size, data, size);
+	self->size += size;
+}
+
+int/*bool*/ _spStateBuffer_read (_spStateBuffer* self, void* data, int size) {
+	if (self->error || self->size + size > self->capacity) {
+		self->error = 1;
+		return 0;
+	}
+	if (size > 0) memcpy(data, self->data + self->size, size);
+	self->size += size;
+	return 1;
+}
+
+void _spStateBuffer_writeInt (_spStateBuffer* self, int value) {
+	_spStateBuffer_write(self, &value, sizeof(int));
+}
+
+int _spStateBuffer_readInt (_spStateBuffer* self) {
+	int value = 0;
+	_spStateBuffer_read(self, &value, sizeof(int));
+	return value;
+}
+
+void _spStateBuffer_expectInt (_spStateBuffer* self, int expected) {
+	if (_spStateBuffer_readInt(self) != expected) self->error = 1;
+}
+
+int _spNameTable_find (const _spNameTable* self, const char* name) {
+	unsigned int bucket;
+	if (!self->capacity) return -1;
+	bucket = _spNameTable_hash(name) & (self->capacity - 1);
+	while (self->entries[bucket]) {
+		int index = self->entries[bucket] - 1;
+		if (strcmp(self->names[index], name) == 0) return index;
+		bucket = (bucket + 1) & (self->capacity - 1);
+	}
+	return -1;
+}
+
+int/*bool*/ _spContainsName (const char** names, int namesCount, const char* name) {
+	int i;
+	if (!names) return 1;
+	for (i = 0; i < namesCount; ++i)
+		if (strcmp(names[i], name) == 0) return 1;
+	return 0;
+}